@@ -1,1079 +1,1295 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <ctype.h>
-#include <string.h>
-#include <stdbool.h> // For bool type
-
-#define MAX_LEXEME_LEN 50
-
-typedef enum tokenType {
-    IDENTIFIER,
-    OPERATION,
-    KEYWORDS,
-    RESERVED_WORDS,
-    CONSTANT,
-    NOISE_WORDS,
-    COMMENT,
-    WHITE_SPACE,
-    DELIMITER
-} TokenType;
-    
-struct Node {
-    TokenType tokentype;
-    char lexeme [1000];
-    int line;
-    int column;
-    struct Node* next;
-};
-
-struct LexemeNode {
-    char lexeme [1000];
-    int line;
-    int column;
-    struct LexemeNode* next;
-};
-
-void readFileAndStoreLexemes(const char *filename, struct LexemeNode **head);
-void lexicalAnalyzer(char* word, struct Node** head, int line, int column);
-struct Node* createNode(TokenType tokentype, char lexeme[], int line, int column);
-struct LexemeNode* createNodeLexeme(char lexeme[], int line, int column);
-void insertAtBeginning(struct Node** head, TokenType tokentype, char lexeme[], int line, int column);
-void insertAtBeginningLexeme(struct LexemeNode** head, char lexeme[], int line, int column);
-void insertAtEnd(struct Node** head, TokenType tokentype, char lexeme[], int line, int column);
-void insertAtEndLexeme(struct LexemeNode** head, char lexeme[], int line, int column);
-void displayList(struct Node* head);
-void displayListLexeme(struct LexemeNode* head);
-void writeSymbolTableToFile(struct Node* head, const char* filename);
-
-int main () {
-    struct LexemeNode* lexeme_head = NULL;
-    struct Node* token_head = NULL;
-    
-    readFileAndStoreLexemes("SourceCode.lxc", &lexeme_head);
-
-    struct LexemeNode* temp = lexeme_head;
-    while (temp != NULL) {
-        lexicalAnalyzer(temp->lexeme, &token_head, temp->line, temp->column);
-        temp = temp->next;
-    }
-    
-    // Write symbol table to file
-    writeSymbolTableToFile(token_head, "SymbolTable.txt");
-
-    return 0;
-}
-
-// function to read all characters and make a node for each lexeme
-void readFileAndStoreLexemes(const char *filename, struct LexemeNode **head) {
-    
-    size_t len = strlen(filename);
-
-   // Clean trailing newline and spaces
-    while (len > 0 &&
-        (filename[len - 1] == '\n' ||
-        filename[len - 1] == '\r' ||
-        filename[len - 1] == ' '))
-    {
-        len--;
-    }
-
-    // If filename is too short to have ".lxc"
-    if (len < 4) {
-        fprintf(stderr, "Error: Only .lxc files are allowed.\n");
-        exit(1);
-    }
-
-    // Manual extension check without strcmp()
-    char e1 = filename[len - 4];
-    char e2 = filename[len - 3];
-    char e3 = filename[len - 2];
-    char e4 = filename[len - 1];
-
-    if (e1 != '.' || e2 != 'l' || e3 != 'x' || e4 != 'c') {
-        fprintf(stderr, "Error: Only .lxc files are allowed.\n");
-        exit(1);
-    }
-
-
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
-        perror("Error opening file");
-        exit(1);   // terminate if file can't be opened
-    }
-
-    int ch, next_ch;
-    int line = 1;
-    int column = 1;
-    char lexeme[MAX_LEXEME_LEN] = "";
-    int lexeme_index = 0;
-    char delimiter[4] = "";
-
-    while ((ch = fgetc(file)) != EOF) {
-        bool isFloatDot = false;
-        if (ch == '.') {
-            next_ch = fgetc(file);
-            if (isdigit(next_ch)) {
-                isFloatDot = true;
-            }
-            ungetc(next_ch, file); // Put the character back for now
-        }
-
-        if ((isspace(ch) || ispunct(ch)) && !isFloatDot) {
-
-            // Store accumulated word before delimiter
-            if (lexeme_index > 0) {
-                lexeme[lexeme_index] = '\0';
-                insertAtEndLexeme(head, lexeme, line, column - lexeme_index);
-                lexeme_index = 0;
-            }
-
-            // Handle newlines and spaces
-            if (ch == '\n') {
-                insertAtEndLexeme(head, "\n", line, column);
-                line++;
-                column = 1;
-                continue;
-            } else if (ch == '\t') {
-                insertAtEndLexeme(head, "\t", line, column);
-                column += 4;
-                continue;
-            } else if (isspace(ch)) {
-                insertAtEndLexeme(head, " ", line, column);
-                column++;
-                continue;
-            }
-
-            // Punctuation: peek next
-            next_ch = fgetc(file);
-
-            // --- Single-line comment (##) ---
-            if (ch == '#' && next_ch == '#') {
-                char comment[MAX_LEXEME_LEN] = "##";
-                int i = 2;
-                while ((ch = fgetc(file)) != EOF && ch != '\n' && i < MAX_LEXEME_LEN - 1) {
-                    comment[i++] = ch;
-                }
-                comment[i] = '\0';
-                insertAtEndLexeme(head, comment, line, column);
-                if (ch == '\n') {
-                    insertAtEndLexeme(head, "\n", line, column);
-                    line++;
-                    column = 1;
-                }
-                continue;
-            }
-
-            // --- Multi-line comment (#* ... *#) ---
-            if (ch == '#' && next_ch == '*') {
-                char comment[MAX_LEXEME_LEN * 10] = "#*";  // buffer for comment
-                int i = 2;
-                char prev = '*';  // Initialize to '*' since we already have "#*"
-
-                while ((ch = fgetc(file)) != EOF && i < (int)sizeof(comment) - 1) {
-                    comment[i] = ch;  // Store character WITHOUT incrementing yet
-                    
-                    if (ch == '\n') {
-                        line++;
-                        column = 1;
-                    } else {
-                        column++;
-                    }
-
-                    // Check if we found the terminator *#
-                    if (prev == '*' && ch == '#') {
-                        i++;  // NOW increment to include the '#'
-                        break;  // Exit the loop, we've captured the full comment
-                    }
-
-                    i++;  // Increment after the check
-                    prev = ch;  // Update prev for next iteration
-                }
-
-                comment[i] = '\0';
-                insertAtEndLexeme(head, comment, line, column);
-                continue;
-            }
-
-            // --- Two-character operators ---
-            char two_char[3] = { (char)ch, (char)next_ch, '\0' };
-                if (
-            // Equality / inequality
-            (ch == '=' && next_ch == '=') ||
-            (ch == '!' && next_ch == '=') ||
-
-            // Relational
-            (ch == '>' && next_ch == '=') ||
-            (ch == '<' && next_ch == '=') ||
-
-            // Increment / decrement
-            (ch == '+' && next_ch == '+') ||
-            (ch == '-' && next_ch == '-') ||
-
-            // Assignment variations
-            (ch == '+' && next_ch == '=') ||
-            (ch == '-' && next_ch == '=') ||
-            (ch == '*' && next_ch == '=') ||
-            (ch == '/' && next_ch == '=') ||
-
-            // Exponent
-            (ch == '*' && next_ch == '*') ||
-
-            // Div operator //
-            (ch == '/' && next_ch == '/') ||
-
-            // Logical operators
-            (ch == '&' && next_ch == '&') ||
-            (ch == '|' && next_ch == '|') ||
-
-            // Arrow operator
-            (ch == '-' && next_ch == '>')
-        ) {
-            insertAtEndLexeme(head, two_char, line, column);
-            column += 2;
-            } else {
-                ungetc(next_ch, file);
-                delimiter[0] = (char)ch;
-                delimiter[1] = '\0';
-                insertAtEndLexeme(head, delimiter, line, column);
-                column++;
-            }
-
-        } else {
-            // Build normal lexeme
-            if (lexeme_index < MAX_LEXEME_LEN - 1) {
-                lexeme[lexeme_index++] = ch;
-            }
-            column++;
-        }
-    }
-
-    // Handle final lexeme
-    if (lexeme_index > 0) {
-        lexeme[lexeme_index] = '\0';
-        insertAtEndLexeme(head, lexeme, line, column - lexeme_index);
-    }
-
-    fclose(file);
-}
-
-// --- NEW: Logic from Keyword.c ---
-// Define all states with meaningful names
-enum States {
-    STATE_START = 0,
-    
-    // Keywords
-    STATE_A, STATE_AR, STATE_ARR, STATE_ARRA, STATE_ARRAY,
-    STATE_B, STATE_BA, STATE_BAC, STATE_BACK, STATE_BO, STATE_BOO, STATE_BOOL,
-    STATE_BR, STATE_BRE, STATE_BREA, STATE_BREAK,
-    STATE_C, STATE_CA, STATE_CAT, STATE_CATC, STATE_CATCH,
-    STATE_CH, STATE_CHA, STATE_CHAR,
-    STATE_CL, STATE_CLA, STATE_CLAS, STATE_CLASS,
-    STATE_CO, STATE_COM, STATE_COMP, STATE_COMPA, STATE_COMPAR, STATE_COMPARE,
-    STATE_CON, STATE_CONS, STATE_CONT, STATE_CONTI, STATE_CONTIN, STATE_CONTINU, STATE_CONTINUE,
-    STATE_D, STATE_DA, STATE_DAT, STATE_DATE,
-    STATE_DI, STATE_DIS, STATE_DISP, STATE_DISPL, STATE_DISPLA, STATE_DISPLAY,
-    STATE_DO,
-    STATE_E, STATE_EN, STATE_END, STATE_EX, STATE_EXC, STATE_EXCL, STATE_EXCLU, STATE_EXCLUS,
-    STATE_EXCLUSI, STATE_EXCLUSIV, STATE_EXCLUSIVE,
-    STATE_F, STATE_FL, STATE_FLO, STATE_FLOA, STATE_FLOAT,
-    STATE_FU, STATE_FUN, STATE_FUNC,
-    STATE_G, STATE_GO,
-    STATE_H, STATE_HA, STATE_HAL, STATE_HALT,
-    STATE_I, STATE_IN, STATE_INT,
-    STATE_INC, STATE_INCL, STATE_INCLU, STATE_INCLUS, STATE_INCLUSI,
-    STATE_INCLUSIV, STATE_INCLUSIVE,
-    STATE_L, STATE_LE, STATE_LET, STATE_LI, STATE_LIS, STATE_LIST,
-    STATE_O, STATE_OU, STATE_OUT, STATE_ON, STATE_ONL, STATE_ONLY,
-    STATE_P, STATE_PR, STATE_PRI, STATE_PRIV, STATE_PU, STATE_PUB, STATE_PUT,
-    STATE_R, STATE_RE, STATE_RET, STATE_RETU, STATE_RETUR, STATE_RETURN,
-    STATE_S, STATE_ST, STATE_STO, STATE_STOP,
-    STATE_T, STATE_TE, STATE_TES, STATE_TEST, STATE_TEX, STATE_TEXT,
-    STATE_TH, STATE_THI, STATE_THIS, STATE_THE, STATE_THEN,
-    STATE_TI, STATE_TIM, STATE_TIME, STATE_TIMES, STATE_TIMEST, STATE_TIMESTA,
-    STATE_TIMESTAM, STATE_TIMESTAMP,
-    STATE_TR, STATE_TRY,
-    STATE_V, STATE_VA, STATE_VAR,
-    STATE_W, STATE_WH, STATE_WHA, STATE_WHAT, STATE_WHE, STATE_WHEN,
-    STATE_WHI, STATE_WHIL, STATE_WHILE,
-    
-    // Reserved Words
-    STATE_T_RES, STATE_TR_RES, STATE_TRU_RES, STATE_TRUE,
-    STATE_F_RES, STATE_FA, STATE_FAL, STATE_FALS, STATE_FALSE,
-    STATE_E_RES, STATE_EX_RES, STATE_EXI, STATE_EXIT,
-    STATE_C_RES, STATE_CE, STATE_CEA, STATE_CEAS, STATE_CEASE,
-    STATE_S_RES, STATE_SY, STATE_SYS, STATE_SYST, STATE_SYSTE, STATE_SYSTEM,
-    STATE_G_RES, STATE_GO_RES, STATE_GOT, STATE_GOTO
-};
-
-
-const char* check_keyword_or_reserved(const char* word) {
-    int state = STATE_START;
-    char ch;
-
-    for (int i = 0; (ch = word[i]) != '\0'; i++) {
-        switch (state) {
-            case STATE_START:
-                if (ch == 'a') state = STATE_A;
-                else if (ch == 'b') state = STATE_B;
-                else if (ch == 'c') state = STATE_C;
-                else if (ch == 'd') state = STATE_D;
-                else if (ch == 'e') state = STATE_E;
-                else if (ch == 'f') state = STATE_F;
-                else if (ch == 'g') state = STATE_G;
-                else if (ch == 'h') state = STATE_H;
-                else if (ch == 'i') state = STATE_I;
-                else if (ch == 'l') state = STATE_L;
-                else if (ch == 'o') state = STATE_O;
-                else if (ch == 'p') state = STATE_P;
-                else if (ch == 'r') state = STATE_R;
-                else if (ch == 's') state = STATE_S;
-                else if (ch == 't') state = STATE_T;
-                else if (ch == 'v') state = STATE_V;
-                else if (ch == 'w') state = STATE_W;
-                else return "IDENTIFIER";
-                break;
-
-            // --- array ---
-            case STATE_A: if (ch == 'r') state = STATE_AR; else return "IDENTIFIER"; break;
-            case STATE_AR: if (ch == 'r') state = STATE_ARR; else return "IDENTIFIER"; break;
-            case STATE_ARR: if (ch == 'a') state = STATE_ARRA; else return "IDENTIFIER"; break;
-            case STATE_ARRA: if (ch == 'y') state = STATE_ARRAY; else return "IDENTIFIER"; break;
-
-            // --- back, bool, break ---
-            case STATE_B:
-                if (ch == 'a') state = STATE_BA;
-                else if (ch == 'o') state = STATE_BO;
-                else if (ch == 'r') state = STATE_BR;
-                else return "IDENTIFIER";
-                break;
-            case STATE_BA: if (ch == 'c') state = STATE_BAC; else return "IDENTIFIER"; break;
-            case STATE_BAC: if (ch == 'k') state = STATE_BACK; else return "IDENTIFIER"; break;
-            case STATE_BO: if (ch == 'o') state = STATE_BOO; else return "IDENTIFIER"; break;
-            case STATE_BOO: if (ch == 'l') state = STATE_BOOL; else return "IDENTIFIER"; break;
-            case STATE_BR: if (ch == 'e') state = STATE_BRE; else return "IDENTIFIER"; break;
-            case STATE_BRE: if (ch == 'a') state = STATE_BREA; else return "IDENTIFIER"; break;
-            case STATE_BREA: if (ch == 'k') state = STATE_BREAK; else return "IDENTIFIER"; break;
-
-            // --- catch, char, class, compare, cons, continue, cease ---
-            case STATE_C:
-                if (ch == 'a') state = STATE_CA;
-                else if (ch == 'h') state = STATE_CH;
-                else if (ch == 'l') state = STATE_CL;
-                else if (ch == 'o') state = STATE_CO;
-                else if (ch == 'e') state = STATE_CE;
-                else return "IDENTIFIER";
-                break;
-            case STATE_CA: if (ch == 't') state = STATE_CAT; else return "IDENTIFIER"; break;
-            case STATE_CAT: if (ch == 'c') state = STATE_CATC; else return "IDENTIFIER"; break;
-            case STATE_CATC: if (ch == 'h') state = STATE_CATCH; else return "IDENTIFIER"; break;
-            case STATE_CH: if (ch == 'a') state = STATE_CHA; else return "IDENTIFIER"; break;
-            case STATE_CHA: if (ch == 'r') state = STATE_CHAR; else return "IDENTIFIER"; break;
-            case STATE_CL: if (ch == 'a') state = STATE_CLA; else return "IDENTIFIER"; break;
-            case STATE_CLA: if (ch == 's') state = STATE_CLAS; else return "IDENTIFIER"; break;
-            case STATE_CLAS: if (ch == 's') state = STATE_CLASS; else return "IDENTIFIER"; break;
-            case STATE_CO:
-                if (ch == 'm') state = STATE_COM;
-                else if (ch == 'n') state = STATE_CON;
-                else return "IDENTIFIER";
-                break;
-            case STATE_COM: if (ch == 'p') state = STATE_COMP; else return "IDENTIFIER"; break;
-            case STATE_COMP: if (ch == 'a') state = STATE_COMPA; else return "IDENTIFIER"; break;
-            case STATE_COMPA: if (ch == 'r') state = STATE_COMPAR; else return "IDENTIFIER"; break;
-            case STATE_COMPAR: if (ch == 'e') state = STATE_COMPARE; else return "IDENTIFIER"; break;
-            case STATE_CON:
-                if (ch == 's') state = STATE_CONS;
-                else if (ch == 't') state = STATE_CONT;
-                else return "IDENTIFIER";
-                break;
-            case STATE_CONT: if (ch == 'i') state = STATE_CONTI; else return "IDENTIFIER"; break;
-            case STATE_CONTI: if (ch == 'n') state = STATE_CONTIN; else return "IDENTIFIER"; break;
-            case STATE_CONTIN: if (ch == 'u') state = STATE_CONTINU; else return "IDENTIFIER"; break;
-            case STATE_CONTINU: if (ch == 'e') state = STATE_CONTINUE; else return "IDENTIFIER"; break;
-            case STATE_CE: if (ch == 'a') state = STATE_CEA; else return "IDENTIFIER"; break;
-            case STATE_CEA: if (ch == 's') state = STATE_CEAS; else return "IDENTIFIER"; break;
-            case STATE_CEAS: if (ch == 'e') state = STATE_CEASE; else return "IDENTIFIER"; break;
-
-            // --- date, display, do ---
-            case STATE_D:
-                if (ch == 'a') state = STATE_DA;
-                else if (ch == 'i') state = STATE_DI;
-                else if (ch == 'o') state = STATE_DO;
-                else return "IDENTIFIER";
-                break;
-            case STATE_DA: if (ch == 't') state = STATE_DAT; else return "IDENTIFIER"; break;
-            case STATE_DAT: if (ch == 'e') state = STATE_DATE; else return "IDENTIFIER"; break;
-            case STATE_DI: if (ch == 's') state = STATE_DIS; else return "IDENTIFIER"; break;
-            case STATE_DIS: if (ch == 'p') state = STATE_DISP; else return "IDENTIFIER"; break;
-            case STATE_DISP: if (ch == 'l') state = STATE_DISPL; else return "IDENTIFIER"; break;
-            case STATE_DISPL: if (ch == 'a') state = STATE_DISPLA; else return "IDENTIFIER"; break;
-            case STATE_DISPLA: if (ch == 'y') state = STATE_DISPLAY; else return "IDENTIFIER"; break;
-
-            // --- exclusive, exit ---
-            case STATE_E:
-                if (ch == 'x') state = STATE_EX;
-                else if (ch == 'n') state = STATE_EN;
-                else return "IDENTIFIER";
-                break;
-            case STATE_EX:
-                if (ch == 'c') state = STATE_EXC;
-                else if (ch == 'i') state = STATE_EXI;
-                else return "IDENTIFIER";
-                break;
-            case STATE_EN: if (ch == 'd') state = STATE_END; else return "IDENTIFIER"; break;
-            case STATE_EXC: if (ch == 'l') state = STATE_EXCL; else return "IDENTIFIER"; break;
-            case STATE_EXCL: if (ch == 'u') state = STATE_EXCLU; else return "IDENTIFIER"; break;
-            case STATE_EXCLU: if (ch == 's') state = STATE_EXCLUS; else return "IDENTIFIER"; break;
-            case STATE_EXCLUS: if (ch == 'i') state = STATE_EXCLUSI; else return "IDENTIFIER"; break;
-            case STATE_EXCLUSI: if (ch == 'v') state = STATE_EXCLUSIV; else return "IDENTIFIER"; break;
-            case STATE_EXCLUSIV: if (ch == 'e') state = STATE_EXCLUSIVE; else return "IDENTIFIER"; break;
-            case STATE_EXI: if (ch == 't') state = STATE_EXIT; else return "IDENTIFIER"; break;
-
-            // --- float, func, false ---
-            case STATE_F:
-                if (ch == 'l') state = STATE_FL;
-                else if (ch == 'u') state = STATE_FU;
-                else if (ch == 'a') state = STATE_FA;
-                else return "IDENTIFIER";
-                break;
-            case STATE_FL: if (ch == 'o') state = STATE_FLO; else return "IDENTIFIER"; break;
-            case STATE_FLO: if (ch == 'a') state = STATE_FLOA; else return "IDENTIFIER"; break;
-            case STATE_FLOA: if (ch == 't') state = STATE_FLOAT; else return "IDENTIFIER"; break;
-            case STATE_FU: if (ch == 'n') state = STATE_FUN; else return "IDENTIFIER"; break;
-            case STATE_FUN: if (ch == 'c') state = STATE_FUNC; else return "IDENTIFIER"; break;
-            case STATE_FA: if (ch == 'l') state = STATE_FAL; else return "IDENTIFIER"; break;
-            case STATE_FAL: if (ch == 's') state = STATE_FALS; else return "IDENTIFIER"; break;
-            case STATE_FALS: if (ch == 'e') state = STATE_FALSE; else return "IDENTIFIER"; break;
-
-            // --- go, goto ---
-            case STATE_G:
-                if (ch == 'o') state = STATE_GO;
-                else return "IDENTIFIER";
-                break;
-            case STATE_GO:
-                if (ch == 't') state = STATE_GOT;
-                else return "KEYWORD";
-                break;
-            case STATE_GOT: if (ch == 'o') state = STATE_GOTO; else return "IDENTIFIER"; break;
-
-            // --- halt ---
-            case STATE_H: if (ch == 'a') state = STATE_HA; else return "IDENTIFIER"; break;
-            case STATE_HA: if (ch == 'l') state = STATE_HAL; else return "IDENTIFIER"; break;
-            case STATE_HAL: if (ch == 't') state = STATE_HALT; else return "IDENTIFIER"; break;
-
-            // --- in, int, inclusive ---
-            case STATE_I: if (ch == 'n') state = STATE_IN; else return "IDENTIFIER"; break;
-            case STATE_IN:
-                if (ch == 't') state = STATE_INT;
-                else if (ch == 'c') state = STATE_INC;
-                else return "KEYWORD";
-                break;
-            case STATE_INC: if (ch == 'l') state = STATE_INCL; else return "IDENTIFIER"; break;
-            case STATE_INCL: if (ch == 'u') state = STATE_INCLU; else return "IDENTIFIER"; break;
-            case STATE_INCLU: if (ch == 's') state = STATE_INCLUS; else return "IDENTIFIER"; break;
-            case STATE_INCLUS: if (ch == 'i') state = STATE_INCLUSI; else return "IDENTIFIER"; break;
-            case STATE_INCLUSI: if (ch == 'v') state = STATE_INCLUSIV; else return "IDENTIFIER"; break;
-            case STATE_INCLUSIV: if (ch == 'e') state = STATE_INCLUSIVE; else return "IDENTIFIER"; break;
-
-            // --- let, list ---
-            case STATE_L:
-                if (ch == 'e') state = STATE_LE;
-                else if (ch == 'i') state = STATE_LI;
-                else return "IDENTIFIER";
-                break;
-            case STATE_LE: if (ch == 't') state = STATE_LET; else return "IDENTIFIER"; break;
-            case STATE_LI: if (ch == 's') state = STATE_LIS; else return "IDENTIFIER"; break;
-            case STATE_LIS: if (ch == 't') state = STATE_LIST; else return "IDENTIFIER"; break;
-
-            // --- out, only ---
-            case STATE_O:
-                if (ch == 'u') state = STATE_OU;
-                else if (ch == 'n') state = STATE_ON;
-                else return "IDENTIFIER";
-                break;
-            case STATE_OU: if (ch == 't') state = STATE_OUT; else return "IDENTIFIER"; break;
-            case STATE_ON: if (ch == 'l') state = STATE_ONL; else return "IDENTIFIER"; break;
-            case STATE_ONL: if (ch == 'y') state = STATE_ONLY; else return "IDENTIFIER"; break;
-
-            // --- priv, pub, put ---
-            case STATE_P:
-                if (ch == 'r') state = STATE_PR;
-                else if (ch == 'u') state = STATE_PU;
-                else return "IDENTIFIER";
-                break;
-            case STATE_PR: if (ch == 'i') state = STATE_PRI; else return "IDENTIFIER"; break;
-            case STATE_PRI: if (ch == 'v') state = STATE_PRIV; else return "IDENTIFIER"; break;
-            case STATE_PU:
-                if (ch == 'b') state = STATE_PUB;
-                else if (ch == 't') state = STATE_PUT;
-                else return "IDENTIFIER";
-                break;
-
-            // --- return ---
-            case STATE_R: if (ch == 'e') state = STATE_RE; else return "IDENTIFIER"; break;
-            case STATE_RE: if (ch == 't') state = STATE_RET; else return "IDENTIFIER"; break;
-            case STATE_RET: if (ch == 'u') state = STATE_RETU; else return "IDENTIFIER"; break;
-            case STATE_RETU: if (ch == 'r') state = STATE_RETUR; else return "IDENTIFIER"; break;
-            case STATE_RETUR: if (ch == 'n') state = STATE_RETURN; else return "IDENTIFIER"; break;
-
-            // --- stop, system ---
-            case STATE_S:
-                if (ch == 't') state = STATE_ST;
-                else if (ch == 'y') state = STATE_SY;
-                else return "IDENTIFIER";
-                break;
-            case STATE_ST: if (ch == 'o') state = STATE_STO; else return "IDENTIFIER"; break;
-            case STATE_STO: if (ch == 'p') state = STATE_STOP; else return "IDENTIFIER"; break;
-            case STATE_SY: if (ch == 's') state = STATE_SYS; else return "IDENTIFIER"; break;
-            case STATE_SYS: if (ch == 't') state = STATE_SYST; else return "IDENTIFIER"; break;
-            case STATE_SYST: if (ch == 'e') state = STATE_SYSTE; else return "IDENTIFIER"; break;
-            case STATE_SYSTE: if (ch == 'm') state = STATE_SYSTEM; else return "IDENTIFIER"; break;
-
-            // --- test, text, this, time, timestamp, try, true ---
-            case STATE_T:
-                if (ch == 'e') state = STATE_TE;
-                else if (ch == 'h') state = STATE_TH;
-                else if (ch == 'i') state = STATE_TI;
-                else if (ch == 'r') state = STATE_TR;
-                else return "IDENTIFIER";
-                break;
-            case STATE_TE:
-                if (ch == 's') state = STATE_TES;
-                else if (ch == 'x') state = STATE_TEX;
-                else return "IDENTIFIER";
-                break;
-            case STATE_TES: if (ch == 't') state = STATE_TEST; else return "IDENTIFIER"; break;
-            case STATE_TEX: if (ch == 't') state = STATE_TEXT; else return "IDENTIFIER"; break;
-            case STATE_TH: 
-                if (ch == 'i') state = STATE_THI; 
-                else if (ch == 'e') state = STATE_THE;
-                else return "IDENTIFIER"; break;
-            case STATE_THI: if (ch == 's') state = STATE_THIS; else return "IDENTIFIER"; break;
-            case STATE_THE: if (ch == 'n') state = STATE_THEN; else return "IDENTIFIER"; break;
-            case STATE_TI: if (ch == 'm') state = STATE_TIM; else return "IDENTIFIER"; break;
-            case STATE_TIM: if (ch == 'e') state = STATE_TIME; else return "IDENTIFIER"; break;
-            case STATE_TIME:
-                if (ch == 's') state = STATE_TIMES;
-                else return "KEYWORD";
-                break;
-            case STATE_TIMES: if (ch == 't') state = STATE_TIMEST; else return "IDENTIFIER"; break;
-            case STATE_TIMEST: if (ch == 'a') state = STATE_TIMESTA; else return "IDENTIFIER"; break;
-            case STATE_TIMESTA: if (ch == 'm') state = STATE_TIMESTAM; else return "IDENTIFIER"; break;
-            case STATE_TIMESTAM: if (ch == 'p') state = STATE_TIMESTAMP; else return "IDENTIFIER"; break;
-            case STATE_TR:
-                if (ch == 'y') state = STATE_TRY;
-                else if (ch == 'u') state = STATE_TRU_RES;
-                else return "IDENTIFIER";
-                break;
-            case STATE_TRU_RES: if (ch == 'e') state = STATE_TRUE; else return "IDENTIFIER"; break;
-
-            // --- var ---
-            case STATE_V: if (ch == 'a') state = STATE_VA; else return "IDENTIFIER"; break;
-            case STATE_VA: if (ch == 'r') state = STATE_VAR; else return "IDENTIFIER"; break;
-
-            // --- what, when, while ---
-            case STATE_W: if (ch == 'h') state = STATE_WH; else return "IDENTIFIER"; break;
-            case STATE_WH:
-                if (ch == 'a') state = STATE_WHA;
-                else if (ch == 'e') state = STATE_WHE;
-                else if (ch == 'i') state = STATE_WHI;
-                else return "IDENTIFIER";
-                break;
-            case STATE_WHA: if (ch == 't') state = STATE_WHAT; else return "IDENTIFIER"; break;
-            case STATE_WHE: if (ch == 'n') state = STATE_WHEN; else return "IDENTIFIER"; break;
-            case STATE_WHI: if (ch == 'l') state = STATE_WHIL; else return "IDENTIFIER"; break;
-            case STATE_WHIL: if (ch == 'e') state = STATE_WHILE; else return "IDENTIFIER"; break;
-
-            default:
-                return "IDENTIFIER";
-        }
-    }
-
-    // Check final state
-    switch (state) {
-        // Keywords
-        case STATE_ARRAY: case STATE_BACK: case STATE_BOOL: case STATE_BREAK:
-        case STATE_CATCH: case STATE_CHAR: case STATE_CLASS: case STATE_COMPARE:
-        case STATE_CONS: case STATE_CONTINUE: case STATE_DO: case STATE_DATE:
-        case STATE_DISPLAY: case STATE_EXCLUSIVE: case STATE_FLOAT: case STATE_FUNC:
-        case STATE_GO: case STATE_HALT: case STATE_IN: case STATE_INT:
-        case STATE_INCLUSIVE: case STATE_LET: case STATE_LIST: case STATE_OUT:
-        case STATE_ONLY: case STATE_PRIV: case STATE_PUB: case STATE_PUT:
-        case STATE_RETURN: case STATE_STOP: case STATE_TEST: case STATE_TEXT:
-        case STATE_THIS: case STATE_TIME: case STATE_TIMESTAMP: case STATE_TRY:
-        case STATE_VAR: case STATE_WHAT: case STATE_WHEN: case STATE_WHILE: case STATE_THEN:
-            return "KEYWORD";
-
-        case STATE_END:
-            return "NOISE_WORD";
-        
-        // Reserved Words
-        case STATE_TRUE: case STATE_FALSE: case STATE_EXIT:
-        case STATE_CEASE: case STATE_SYSTEM: case STATE_GOTO:
-            return "RESERVED_WORD";
-        
-        default:
-            return "IDENTIFIER";
-    }
-}
-
-/**
- * This is the fully synchronized lexical analyzer.
- * It combines the logic from all your files.
- *
- * This single function implements the complete DFA.
- */
-void lexicalAnalyzer(char* word, struct Node** head, int line, int column) {
-    int i = 0;
-    int len = (int)strlen(word);
-    int current_column = column;
-
-    while (i < len) {
-        char currentChar = word[i];
-
-        // This switch statement handles the transitions from the START state
-        switch (currentChar) {
-
-            // --- Logic from operationSymbol.c ---
-        case '+':
-            if (i + 1 < len && word[i + 1] == '+') {
-                insertAtEnd(head, OPERATION, "++", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "+=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "+", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '-':
-            if (i + 1 < len && word[i + 1] == '-') {
-                insertAtEnd(head, OPERATION, "--", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "-=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "-", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '*':
-            // Check for multi-line comment end first
-            if (i + 1 < len && word[i + 1] == '#') {
-                insertAtEnd(head, COMMENT, "*#", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "*=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else if (i + 1 < len && word[i + 1] == '*') {
-                insertAtEnd(head, OPERATION, "**", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "*", line, current_column);
-                i++; current_column++;
-            }
-            break;
-         case '/':
-            if (i + 1 < len && word[i + 1] == '/') {
-                insertAtEnd(head, OPERATION, "//", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "/=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "/", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '%':
-            if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "%=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "%", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '<':
-            if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "<=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "<", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '>':
-            if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, ">=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, ">", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '=':
-            if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "==", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "=", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '!':
-            if (i + 1 < len && word[i + 1] == '=') {
-                insertAtEnd(head, OPERATION, "!=", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                insertAtEnd(head, OPERATION, "!", line, current_column);
-                i++; current_column++;
-            }
-            break;
-        case '&':
-            if (i + 1 < len && word[i + 1] == '&') {
-                insertAtEnd(head, OPERATION, "&&", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                i++; current_column++;
-            }
-            break;
-        case '|':
-            if (i + 1 < len && word[i + 1] == '|') {
-                insertAtEnd(head, OPERATION, "||", line, current_column);
-                i += 2; current_column += 2;
-            }
-            else {
-                i++; current_column++;
-            }
-            break;
-
-            // --- Logic from comment_analyzer.c ---
-        case '#':
-            if (i + 1 < len && word[i + 1] == '*') {
-                // Multi-line comment - store the entire comment
-                insertAtEnd(head, COMMENT, word, line, current_column);
-                return; // Done with this lexeme
-            }
-            else if (i + 1 < len && word[i + 1] == '#') {
-                // Single-line comment - store the entire comment
-                insertAtEnd(head, COMMENT, word, line, current_column);
-                return; // Done with this lexeme
-            }
-            else {
-                i++; current_column++;
-            }
-            break;
-
-            // --- Logic from Delimeters_and_Brackets.c ---
-        case ';':
-            insertAtEnd(head, DELIMITER, ";", line, current_column);
-            i++; current_column++;
-            break;
-        case ':':
-            insertAtEnd(head, DELIMITER, ":", line, current_column);
-            i++; current_column++;
-            break;
-        case ',':
-            insertAtEnd(head, DELIMITER, ",", line, current_column);
-            i++; current_column++;
-            break;
-        case '(':
-            insertAtEnd(head, DELIMITER, "(", line, current_column);
-            i++; current_column++;
-            break;
-        case ')':
-            insertAtEnd(head, DELIMITER, ")", line, current_column);
-            i++; current_column++;
-            break;
-        case '{':
-            insertAtEnd(head, DELIMITER, "{", line, current_column);
-            i++; current_column++;
-            break;
-        case '}':
-            insertAtEnd(head, DELIMITER, "}", line, current_column);
-            i++; current_column++;
-            break;
-        case '[':
-            insertAtEnd(head, DELIMITER, "[", line, current_column);
-            i++; current_column++;
-            break;
-        case ']':
-            insertAtEnd(head, DELIMITER, "]", line, current_column);
-            i++; current_column++;
-            break;
-
-            // --- Logic from Constant.c (String and Char) ---
-        case '"': {
-            char lexeme[1000];
-            int k = 0;
-            int start_col = current_column;
-            lexeme[k++] = word[i++]; current_column++; // Add the opening "
-            while (i < len && word[i] != '"') {
-                lexeme[k++] = word[i++];
-                current_column++;
-            }
-            if (i < len && word[i] == '"') {
-                lexeme[k++] = word[i++]; current_column++; // Add the closing "
-            }
-            lexeme[k] = '\0';
-            insertAtEnd(head, RESERVED_WORDS, lexeme, line, start_col);
-            break;
-        }
-        case '\'': {
-            if (i + 2 < len && word[i + 2] == '\'') {
-                char lexeme[4];
-                lexeme[0] = '\'';
-                lexeme[1] = word[i + 1];
-                lexeme[2] = '\'';
-                lexeme[3] = '\0';
-                insertAtEnd(head, RESERVED_WORDS, lexeme, line, current_column);
-                i += 3; current_column += 3;
-            }
-            else {
-                i++; current_column++;
-            }
-            break;
-        }
-
-        // --- Whitespace Handling ---
-        case ' ':
-        case '\t':
-        case '\n':
-            insertAtEnd(head, WHITE_SPACE, word, line, current_column);
-            i++; // Ignore whitespace for parsing
-            return; // Each whitespace is its own lexeme
-            break;
-
-        // --- MODIFIED: Logic from Constant.c and Keyword.c ---
-        default:
-    // Rule for Numbers (Int/Float) -> CONSTANT
-    if (isdigit(currentChar)) {
-        char lexeme[100];
-        int k = 0;
-        int start_col = current_column;
-        bool hasDecimal = false; // Flag to ensure we only allow one dot
-
-        while (i < len) {
-            // Case 1: It is a digit
-            if (isdigit(word[i])) {
-                lexeme[k++] = word[i++];
-                current_column++;
-            } 
-            // Case 2: It is a dot, and we haven't seen one yet
-            else if (word[i] == '.' && !hasDecimal) {
-                lexeme[k++] = word[i++];
-                current_column++;
-                hasDecimal = true; 
-            } 
-            // Case 3: Second dot or other character -> Stop
-            else {
-                break;
-            }
-        }
-        
-        lexeme[k] = '\0';
-        insertAtEnd(head, CONSTANT, lexeme, line, start_col);}
-
-            // Rule for ALL "Words" -> Check if KEYWORD or IDENTIFIER
-            else if (isalpha(currentChar)) {
-                char lexeme[100];
-                int k = 0;
-                int start_col = current_column;
-                while (i < len && isalnum(word[i])) {
-                    lexeme[k++] = word[i++];
-                    current_column++;
-                }
-                lexeme[k] = '\0';
-
-                // Check if the lexeme is a keyword
-                const char* keyword_result = check_keyword_or_reserved(lexeme);
-
-                if (strncmp(keyword_result, "KEYWORD", 8) == 0) {
-                    // It's a keyword
-                    insertAtEnd(head, KEYWORDS, lexeme, line, start_col);
-                } else if (strncmp(keyword_result, "RESERVED_WORD", 14) == 0){
-                    insertAtEnd(head, RESERVED_WORDS, lexeme, line, start_col);
-                }
-                else if (strncmp(keyword_result, "NOISE_WORD", 10) == 0){
-                    insertAtEnd(head, NOISE_WORDS, lexeme, line, start_col);
-                }
-                else {
-                    // Check if it's a valid identifier
-                    if (!isalpha(lexeme[0]) && lexeme[0] != '_') {
-                        // Invalid identifier
-                    } else {
-                        int valid = 1;
-                        for (int j = 1; lexeme[j] != '\0'; j++) {
-                            if (!isalnum(lexeme[j]) && lexeme[j] != '_') {
-                                valid = 0;
-                                break;
-                            }
-                        }
-
-                        if (valid) {
-                            insertAtEnd(head, IDENTIFIER, lexeme, line, start_col);
-                        }
-                    }
-                }
-            }
-            // Otherwise, it's an unknown symbol
-            else {
-                i++; current_column++;
-            }
-            break;
-        }
-    }
-}
-
-//remember to make an if statements to not exceed 50 chars on lexeme
-struct Node* createNode(TokenType tokentype, char lexeme[], int line, int column) {
-    struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
-    if (!newNode) {
-        printf("Memory allocation failed!\n");
-        exit(1);
-    }
-    newNode->tokentype = tokentype;
-    strcpy(newNode->lexeme, lexeme);
-    newNode->line = line;
-    newNode->column = column;
-    newNode->next = NULL;
-    return newNode;
-}
-
-struct LexemeNode* createNodeLexeme(char lexeme[], int line, int column) {
-    struct LexemeNode* newLexemeNode = (struct LexemeNode*)malloc(sizeof(struct LexemeNode));
-    if (!newLexemeNode) {
-        printf("Memory allocation failed!\n");
-        exit(1);
-    }
-    strcpy(newLexemeNode->lexeme, lexeme);
-    newLexemeNode->line = line;
-    newLexemeNode->column = column;
-    newLexemeNode->next = NULL;
-    return newLexemeNode;
-}
-
-void insertAtBeginning(struct Node** head, TokenType tokentype, char lexeme[], int line, int column) {
-    struct Node* newNode = createNode(tokentype, lexeme, line, column);
-    newNode->next = *head;
-    *head = newNode;
-}
-
-void insertAtBeginningLexeme(struct LexemeNode** head, char lexeme[], int line, int column) {
-    struct LexemeNode* newLexemeNode = createNodeLexeme(lexeme, line, column);
-    newLexemeNode->next = *head;
-    *head = newLexemeNode;
-}
-
-void insertAtEnd(struct Node** head, TokenType tokentype, char lexeme[], int line, int column) {
-    struct Node* newNode = createNode(tokentype, lexeme, line, column);
-    if (*head == NULL) {
-        *head = newNode;
-        return;
-    }
-    struct Node* temp = *head;
-    while (temp->next != NULL) {
-        temp = temp->next;
-    }
-    temp->next = newNode;
-}
-
-void insertAtEndLexeme(struct LexemeNode** head, char lexeme[], int line, int column) {
-    struct LexemeNode* newLexemeNode = createNodeLexeme(lexeme, line, column);
-    if (*head == NULL) {
-        *head = newLexemeNode;
-        return;
-    }
-    struct LexemeNode* temp = *head;
-    while (temp->next != NULL) {
-        temp = temp->next;
-    }
-    temp->next = newLexemeNode;
-}
-
-const char* tokenTypeToString(TokenType type) {
-    switch (type) {
-        case IDENTIFIER: return "IDENTIFIER";
-        case OPERATION: return "OPERATION";
-        case KEYWORDS: return "KEYWORDS";
-        case RESERVED_WORDS: return "RESERVED_WORDS";
-        case CONSTANT: return "CONSTANT";
-        case NOISE_WORDS: return "NOISE_WORDS";
-        case COMMENT: return "COMMENT";
-        case WHITE_SPACE: return "WHITE_SPACE";
-        case DELIMITER: return "DELIMITER";
-        default: return "UNKNOWN";
-    }
-}
-
-void displayList(struct Node* head) {
-    struct Node* temp = head;
-    printf("Token Stream:\n");
-    while (temp != NULL) {
-        printf("<%s, \"%s\">\n", tokenTypeToString(temp->tokentype), temp->lexeme);
-        temp = temp->next;
-    }
-    printf("NULL\n");
-}
-
-void displayListLexeme(struct LexemeNode* head) {
-    struct LexemeNode* temp = head;
-    printf("Token Stream:\n");
-    while (temp != NULL) {
-        printf("<%s>, Line: %d, Column: %d\n", temp->lexeme, temp->line, temp->column);
-        temp = temp->next;
-    }
-    printf("NULL\n");
-}
-
-void writeSymbolTableToFile(struct Node* head, const char* filename) {
-    FILE* file = fopen(filename, "w");
-    if (file == NULL) {
-        perror("Error opening output file");
-        return;
-    }
-
-    // Write each token in simple format
-    struct Node* temp = head;
-    while (temp != NULL) {
-        fprintf(file, "%s ", tokenTypeToString(temp->tokentype));
-        
-        // Write lexeme character by character
-        int len = strlen(temp->lexeme);
-        for (int i = 0; i < len; i++) {
-            if (temp->lexeme[i] == '\n') {
-                fprintf(file, "\\n");
-            } else if (temp->lexeme[i] == '\t') {
-                fprintf(file, "\\t");
-            } else if (temp->lexeme[i] == ' ') {
-                fprintf(file, "_");
-            } else {
-                fputc(temp->lexeme[i], file);
-            }
-        }
-        
-        fprintf(file, "\n");
-
-        temp = temp->next;
-    }
-    
-    fclose(file);
-    printf("Symbol table written to '%s' successfully!\n", filename);
-}
\ No newline at end of file
+#ifndef _WIN32
+#define _GNU_SOURCE  // memmem
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h> // For bool type
+#include <stdint.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "lexer.h"
+#include "charclass.h"
+#include "structure.h"
+
+#ifndef LEXC_DRIVER
+int main () {
+    TokenBuffer tokens;
+    TriviaBuffer trivia;
+    SourceBuffer source;
+    InternTable names;
+
+    const char* problem = openSourceFile("SourceCode.lxc", &source);
+    if (problem != NULL) {
+        fprintf(stderr, "Error: %s\n", problem);
+        exit(1);
+    }
+    initTokenBuffer(&tokens);
+    initTriviaBuffer(&trivia);
+    if (!initInternTable(&names)) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+
+    // Classify tokens straight from the source bytes; large files are split
+    // across all cores, with the same result
+    lexicalAnalyzerParallel(&source, &tokens, &trivia, &names,
+                            source.size >= PARALLEL_LEX_MIN_SIZE ? lexerThreadCount() : 1);
+    
+    // Write the readable symbol table and the binary stream the parser loads
+    writeSymbolTableToFile(&tokens, &trivia, &source, "SymbolTable.txt", SYMBOL_TABLE_TEXT);
+    writeSymbolTableToFile(&tokens, &trivia, &source, "SymbolTable.bin", SYMBOL_TABLE_BINARY);
+
+    freeTokenBuffer(&tokens);
+    freeTriviaBuffer(&trivia);
+    freeInternTable(&names);
+    releaseSourceFile(&source);
+    return 0;
+}
+#endif
+
+// Number of threads worth using for parallel lexing
+int lexerThreadCount(void) {
+#ifdef _WIN32
+    return 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 1 ? (int)count : 1;
+#endif
+}
+
+// Fill the lexer's shared tables; call before lexing on several threads
+void initLexerTables(void) {
+    initKeywordTable();
+    initCharClasses();
+}
+
+// function to validate the .lxc extension and load the whole file; returns
+// NULL, or what is wrong with the file so that the caller can report it
+const char* openSourceFile(const char *filename, SourceBuffer* source) {
+    
+    size_t len = strlen(filename);
+
+   // Clean trailing newline and spaces
+    while (len > 0 &&
+        (filename[len - 1] == '\n' ||
+        filename[len - 1] == '\r' ||
+        filename[len - 1] == ' '))
+    {
+        len--;
+    }
+
+    // If filename is too short to have ".lxc"
+    if (len < 4) {
+        return "Only .lxc files are allowed.";
+    }
+
+    // Manual extension check without strcmp()
+    char e1 = filename[len - 4];
+    char e2 = filename[len - 3];
+    char e3 = filename[len - 2];
+    char e4 = filename[len - 1];
+
+    if (e1 != '.' || e2 != 'l' || e3 != 'x' || e4 != 'c') {
+        return "Only .lxc files are allowed.";
+    }
+
+    if (!loadSourceFile(filename, source, 0)) {
+        return errno == ENOMEM ? "Not enough memory to load the file." : "Cannot open the file.";
+    }
+    return NULL;
+}
+
+static void makeToken(Token* token, TokenKind kind, uint64_t start, size_t length) {
+    memset(token, 0, sizeof(*token));
+    token->start = start;
+    token->length = (uint32_t)length;
+    token->type = token_kind_type[kind];
+    token->kind = (uint8_t)kind;
+}
+
+// Queue a token for nextToken(); one lexing step yields at most a word's worth.
+// start is an offset into the buffered text.
+static void queueToken(Lexer* lexer, TokenKind kind, size_t start, size_t length) {
+    makeToken(&lexer->queue[lexer->queue_count++], kind, lexer->text.offset + start, length);
+}
+
+// Whitespace and comments are tokens only when trivia_tokens asks for them;
+// otherwise they go to the trivia table, if any, with whitespace merged into
+// runs that end at a newline. start is an input offset; a comment need not
+// be buffered any more. Spans are 32-bit, so a comment of 4 GiB or more is
+// recorded in pieces.
+static void recordTrivia(Lexer* lexer, TokenKind kind, uint64_t start, uint64_t length) {
+    while (length > UINT32_MAX) {
+        recordTrivia(lexer, kind, start, UINT32_MAX);
+        start += UINT32_MAX;
+        length -= UINT32_MAX;
+    }
+    if (lexer->trivia_tokens) {
+        makeToken(&lexer->queue[lexer->queue_count++], kind, start, length);
+    } else if (lexer->trivia != NULL) {
+        appendTrivia(lexer->trivia, kind, start, length, lexer->trivia_run);
+        lexer->trivia_run = kind == TK_WHITE_SPACE && lexer->text.data[start - lexer->text.offset] != '\n';
+    }
+}
+
+// A new line starts at offset. For chunked input the table is cut back to
+// the line the window retains whenever it fills, so it stays about as small
+// as the window.
+static void recordLineStart(Lexer* lexer, uint64_t offset) {
+    LineIndex* lines = lexer->lines;
+    if (lines->count == lines->capacity && lexer->read != NULL) {
+        size_t keep = findLine(lines, lexer->retain);
+        if (keep > 0 && keep < lines->count) {
+            memmove(lines->starts, lines->starts + keep, (lines->count - keep) * sizeof(uint64_t));
+            lines->count -= keep;
+            lines->first_line += keep;
+        }
+    }
+    appendLineStart(lines, offset);
+}
+
+// Note the lines that start inside the comment or string text [p, stop)
+static void skipSpanText(Lexer* lexer, const char* p, const char* stop, uint64_t* line_start) {
+    const char* newline;
+    while ((newline = memchr(p, '\n', stop - p)) != NULL) {
+        p = newline + 1;
+        *line_start = lexer->text.offset + (uint64_t)(p - lexer->text.data);
+        if (lexer->lines != NULL) {
+            recordLineStart(lexer, *line_start);
+        }
+    }
+}
+
+// First "*#" in [p, end), or NULL
+static const char* findCommentClose(const char* p, const char* end) {
+#ifndef _WIN32
+    return (const char*)memmem(p, end - p, "*#", 2);
+#else
+    while (end - p >= 2 && (p = memchr(p + 1, '#', end - p - 1)) != NULL) {
+        if (p[-1] == '*') {
+            return p - 1;
+        }
+    }
+    return NULL;
+#endif
+}
+
+// First '"' in [p, end) not escaped by a backslash, or NULL. A backslash
+// escapes the byte after it. If none is found, *resume is where a later
+// search must restart: end, or the last byte when it is a backslash whose
+// escaped byte is not buffered yet.
+static const char* findStringClose(const char* p, const char* end, const char** resume) {
+    const char* quote = memchr(p, '"', end - p);
+
+    for (;;) {
+        const char* backslash = memchr(p, '\\', (quote ? quote : end) - p);
+        if (backslash == NULL) {
+            *resume = end;
+            return quote;
+        }
+        if (backslash + 1 == end) {
+            *resume = backslash;
+            return NULL;
+        }
+        p = backslash + 2;
+        if (quote != NULL && quote < p) {
+            quote = memchr(p, '"', end - p);
+        }
+    }
+}
+
+// Scan the open comment or string from p to its end: the newline (left for
+// the next step) for ##, just past "*#" for #*, just past the closing quote
+// for a string. The search starts at the opening '*' of #*, so "#*#" is
+// already closed. If the end is not buffered yet, all that is buffered is
+// skipped and the span stays open. A comment goes to trivia, a string is
+// queued as one token. Returns where scanning resumes.
+static const char* scanSpan(Lexer* lexer, const char* p, const char* end, uint64_t* line_start) {
+    const char* stop;
+    bool closed = true;
+    TokenKind kind = TK_COMMENT;
+
+    if (lexer->span == '#') {
+        stop = memchr(p, '\n', end - p);
+        if (stop == NULL) {
+            stop = end;
+            closed = lexer->at_eof;
+        }
+    } else if (lexer->span == '*') {
+        stop = findCommentClose(p, end);
+        if (stop != NULL) {
+            stop += 2;
+        } else if (lexer->at_eof) {
+            stop = end;
+        } else {
+            // A '*' at the very end may start the "*#" of the next chunk
+            stop = end[-1] == '*' ? end - 1 : end;
+            closed = false;
+        }
+    } else {
+        const char* resume;
+        kind = TK_STRING;
+        stop = findStringClose(p, end, &resume);
+        if (stop != NULL) {
+            stop++;
+        } else if (lexer->at_eof) {
+            stop = end;
+            kind = TK_UNTERMINATED_STRING;
+        } else {
+            stop = resume;
+            closed = false;
+        }
+    }
+
+    skipSpanText(lexer, p, stop, line_start);
+    if (closed) {
+        uint64_t length = lexer->text.offset + (uint64_t)(stop - lexer->text.data) - lexer->span_start;
+        if (kind == TK_COMMENT) {
+            recordTrivia(lexer, kind, lexer->span_start, length);
+        } else {
+            // A token spans at most 4 GiB of a longer literal
+            makeToken(&lexer->queue[lexer->queue_count++], kind, lexer->span_start,
+                      length < UINT32_MAX ? length : UINT32_MAX);
+        }
+        lexer->span = 0;
+    }
+    return stop;
+}
+
+// Hand out the next queued token. The window keeps the start of its line
+// buffered (within a chunk) so callers can still quote it in error reports.
+static void popToken(Lexer* lexer, Token* token) {
+    *token = lexer->queue[lexer->queue_head++];
+    lexer->retain = token->start - lexer->queue_line_start <= LEXER_CHUNK_SIZE ?
+                    lexer->queue_line_start : token->start;
+}
+
+// Two-character operators that are kept together as one lexeme
+static bool isTwoCharOperator(int ch, int next_ch) {
+    switch (ch) {
+        case '=': case '!': case '>': case '<':
+            return next_ch == '=';
+        case '+':
+            return next_ch == '+' || next_ch == '=';
+        case '-':
+            return next_ch == '-' || next_ch == '=' || next_ch == '>';
+        case '*':
+            return next_ch == '=' || next_ch == '*';
+        case '/':
+            return next_ch == '/' || next_ch == '=';
+        case '&':
+            return next_ch == '&';
+        case '|':
+            return next_ch == '|';
+        default:
+            return false;
+    }
+}
+
+// Split one word (letters, digits, '.' before a digit, ...) into constants,
+// keywords and identifiers. Any other character inside a word is dropped.
+static void analyzeWord(Lexer* lexer, size_t offset, int len) {
+    const char* word = lexer->text.data + offset;
+    int i = 0;
+
+    while (i < len) {
+        unsigned char currentChar = (unsigned char)word[i];
+        int start = i;
+
+        // Rule for Numbers (Int/Float) -> CONSTANT
+        if (IS_CLASS(currentChar, CC_DIGIT)) {
+            bool hasDecimal = false; // Flag to ensure we only allow one dot
+
+            while (i < len) {
+                if (IS_CLASS(word[i], CC_DIGIT)) {
+                    i++;
+                } else if (word[i] == '.' && !hasDecimal) {
+                    i++;
+                    hasDecimal = true;
+                } else {
+                    break;
+                }
+            }
+            queueToken(lexer, TK_CONSTANT, offset + start, i - start);
+        }
+        // Rule for ALL "Words" -> Check if KEYWORD or IDENTIFIER
+        else if (IS_CLASS(currentChar, CC_ALPHA)) {
+            while (i < len && IS_CLASS(word[i], CC_ALNUM)) {
+                i++;
+            }
+            // Keywords, reserved words and noise words come from the keyword table
+            TokenKind kind = lookupKeyword(word + start, i - start);
+            queueToken(lexer, kind, offset + start, i - start);
+            if (kind == TK_IDENTIFIER && lexer->names != NULL) {
+                lexer->queue[lexer->queue_count - 1].name_id = internName(lexer->names, word + start, i - start);
+            }
+        }
+        // Otherwise, it's an unknown symbol
+        else {
+            i++;
+        }
+    }
+}
+
+static void resetLexer(Lexer* lexer) {
+    initKeywordTable();
+    initCharClasses();
+    lexer->read = NULL;
+    lexer->read_context = NULL;
+    lexer->buffer = NULL;
+    lexer->buffer_capacity = 0;
+    lexer->at_eof = true;
+    lexer->in_word = false;
+    lexer->span = 0;
+    lexer->names = NULL;
+    lexer->lines = NULL;
+    lexer->trivia = NULL;
+    lexer->trivia_run = false;
+    lexer->trivia_tokens = false;
+    lexer->stop = UINT64_MAX;
+    lexer->line_start = 0;
+    lexer->retain = 0;
+    lexer->queue_line_start = 0;
+    lexer->queue_head = 0;
+    lexer->queue_count = 0;
+}
+
+// Lex a source that is already in memory
+void initLexer(Lexer* lexer, const SourceBuffer* source) {
+    resetLexer(lexer);
+    lexer->text.data = source->data;
+    lexer->text.offset = 0;
+    lexer->text.size = source->size;
+    lexer->p = source->data;
+}
+
+// Lex the tokens of an in-memory source that start in [start, stop), beginning
+// in the plain (not in a comment or string) state at the start of a line. A
+// token started before stop may run past it.
+void initLexerRange(Lexer* lexer, const SourceBuffer* source, uint64_t start, uint64_t stop) {
+    initLexer(lexer, source);
+    lexer->p = source->data + start;
+    lexer->stop = stop;
+    lexer->line_start = start;
+}
+
+// Lex input pulled through read(context, ...) a chunk at a time, e.g. a pipe
+void initChunkedLexer(Lexer* lexer, ReadChunkFn read, void* context) {
+    resetLexer(lexer);
+    lexer->read = read;
+    lexer->read_context = context;
+    lexer->at_eof = false;
+    lexer->buffer_capacity = 2 * LEXER_CHUNK_SIZE + LEXER_LOOKAHEAD;
+    lexer->buffer = (char*)malloc(lexer->buffer_capacity);
+    if (!lexer->buffer) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    lexer->text.data = lexer->buffer;
+    lexer->text.offset = 0;
+    lexer->text.size = 0;
+    lexer->p = lexer->buffer;
+}
+
+void freeLexer(Lexer* lexer) {
+    free(lexer->buffer);
+    lexer->buffer = NULL;
+}
+
+// The window is about to start at keep: count the tabs that leave it on the
+// line keep is inside, so that columns on that line stay right
+static void countCutTabs(LineIndex* lines, const SourceText* text, uint64_t keep) {
+    size_t line = findLine(lines, keep);
+    uint64_t line_start;
+    const char* p;
+    const char* end = text->data + (keep - text->offset);
+
+    if (line == lines->count) {
+        return;
+    }
+    line_start = lines->starts[line];
+    if (line_start != lines->cut_line) {
+        lines->cut_line = line_start;
+        lines->cut_tabs = 0;
+    }
+    p = text->data + (line_start > text->offset ? line_start - text->offset : 0);
+    while (p < end && (p = (const char*)memchr(p, '\t', end - p)) != NULL) {
+        lines->cut_tabs++;
+        p++;
+    }
+}
+
+// Slide the window forward to the retained text and read chunks until
+// LEXER_LOOKAHEAD bytes follow the scan position p, or the input ends.
+// Returns p relocated into the window.
+static const char* refillLexer(Lexer* lexer, const char* p) {
+    uint64_t scan = lexer->text.offset + (uint64_t)(p - lexer->text.data);
+    uint64_t keep = (lexer->retain >= lexer->text.offset && lexer->retain <= scan) ? lexer->retain : scan;
+    size_t drop = (size_t)(keep - lexer->text.offset);
+    size_t position = (size_t)(scan - keep);
+
+    if (lexer->lines != NULL && drop > 0) {
+        countCutTabs(lexer->lines, &lexer->text, keep);
+    }
+    memmove(lexer->buffer, lexer->buffer + drop, lexer->text.size - drop);
+    lexer->text.offset = keep;
+    lexer->text.size -= drop;
+
+    while (!lexer->at_eof && lexer->text.size - position < LEXER_LOOKAHEAD) {
+        if (lexer->buffer_capacity - lexer->text.size < LEXER_CHUNK_SIZE) {
+            size_t capacity = lexer->text.size + LEXER_CHUNK_SIZE;
+            char* grown = (char*)realloc(lexer->buffer, capacity);
+            if (!grown) {
+                printf("Memory allocation failed!\n");
+                exit(1);
+            }
+            lexer->buffer = grown;
+            lexer->buffer_capacity = capacity;
+        }
+        size_t n = lexer->read(lexer->read_context, lexer->buffer + lexer->text.size, LEXER_CHUNK_SIZE);
+        if (n == 0) {
+            lexer->at_eof = true;
+        }
+        lexer->text.size += n;
+    }
+
+    lexer->text.data = lexer->buffer;
+    return lexer->buffer + position;
+}
+
+/**
+ * Pull-based lexical analyzer.
+ * Returns the next token of the input in *token, or false at end of input.
+ * The input bytes are walked once and every token is classified as it is
+ * found; state between calls is just the scan position and a small queue
+ * for words that split into several tokens. Chunked input is refilled
+ * between tokens, so comments, strings and operators that cross a chunk
+ * boundary come out exactly as they would from a single buffer.
+ */
+bool nextToken(Lexer* lexer, Token* token) {
+    const char* base = lexer->text.data;
+    const char* p = lexer->p;
+    const char* end = base + lexer->text.size;
+    uint64_t line_start = lexer->line_start;
+    bool in_word = lexer->in_word;
+
+    if (lexer->queue_head < lexer->queue_count) {
+        popToken(lexer, token);
+        return true;
+    }
+    lexer->queue_head = 0;
+    lexer->queue_count = 0;
+
+    while (lexer->queue_count == 0) {
+        if (!lexer->at_eof && end - p < LEXER_LOOKAHEAD) {
+            // Nothing is queued, so only the line being scanned must stay
+            // buffered, however much whitespace and comment came before it
+            // (or, inside a string, the string from its opening quote)
+            uint64_t scan = lexer->text.offset + (uint64_t)(p - base);
+            uint64_t keep = lexer->span == '"' && lexer->span_start < line_start ? lexer->span_start : line_start;
+            lexer->retain = scan - keep <= LEXER_CHUNK_SIZE ? keep : scan;
+            p = refillLexer(lexer, p);
+            base = lexer->text.data;
+            end = base + lexer->text.size;
+        }
+        if (lexer->span == 0 && (p >= end || lexer->text.offset + (uint64_t)(p - base) >= lexer->stop)) {
+            break;
+        }
+        lexer->queue_line_start = line_start;
+
+        // --- The rest of a comment or string that ran past the window ---
+        if (lexer->span != 0) {
+            p = scanSpan(lexer, p, end, &line_start);
+            continue;
+        }
+
+        int ch = (unsigned char)*p;
+        bool isFloatDot = (ch == '.' && p + 1 < end && IS_CLASS(p[1], CC_DIGIT));
+
+        // --- Words: everything up to the next space or punctuation ---
+        if (in_word || !IS_CLASS(ch, CC_DELIMITER) || isFloatDot) {
+            // The last buffered byte waits for the next chunk: whether a '.'
+            // there belongs to the word depends on the byte after it
+            const char* limit = lexer->at_eof ? end : end - 1;
+            const char* word_end = p;
+            for (;;) {
+                word_end = findDelimiter(word_end, limit);
+                if (word_end < limit && *word_end == '.' && word_end + 1 < end && IS_CLASS(word_end[1], CC_DIGIT)) {
+                    word_end++;
+                    continue;
+                }
+                break;
+            }
+            // Only the first MAX_LEXEME_LEN - 1 characters of a word are kept;
+            // the lookahead guarantees they are all buffered
+            size_t len = (size_t)(word_end - p);
+            if (!in_word) {
+                analyzeWord(lexer, p - base, len < MAX_LEXEME_LEN - 1 ? (int)len : MAX_LEXEME_LEN - 1);
+            }
+            in_word = (word_end == limit && limit != end);
+            p = word_end;
+            continue;
+        }
+
+        size_t start = p - base;
+        p++;
+
+        // --- Whitespace Handling ---
+        if (ch == '\n') {
+            recordTrivia(lexer, TK_WHITE_SPACE, lexer->text.offset + start, 1);
+            line_start = lexer->text.offset + (p - base);
+            if (lexer->lines != NULL) {
+                recordLineStart(lexer, line_start);
+            }
+            continue;
+        } else if (IS_CLASS(ch, CC_BLANK)) {
+            // The rest of the run in one go
+            p = skipBlanks(p, end);
+            recordTrivia(lexer, TK_WHITE_SPACE, lexer->text.offset + start, (size_t)(p - base) - start);
+            continue;
+        }
+
+        int next_ch = (p < end) ? (unsigned char)*p : EOF;
+
+        // --- Comments: ## to the end of the line, #* ... *# ---
+        // Found with memchr/memmem however long they are; the text between
+        // is never looked at byte by byte
+        if (ch == '#' && (next_ch == '#' || next_ch == '*')) {
+            lexer->span = (char)next_ch;
+            lexer->span_start = lexer->text.offset + start;
+            p = scanSpan(lexer, p, end, &line_start);
+            continue;
+        }
+
+        // --- Strings: one token from quote to quote, found the same way ---
+        // Escapes are only skipped over; nothing downstream needs the decoded value
+        if (ch == '"') {
+            lexer->span = '"';
+            lexer->span_start = lexer->text.offset + start;
+            p = scanSpan(lexer, p, end, &line_start);
+            continue;
+        }
+
+        // --- Two-character operators ---
+        if (isTwoCharOperator(ch, next_ch)) {
+            p++;
+            if (ch == '-' && next_ch == '>') {
+                // The arrow is not an operator of its own; it yields '-' and '>'
+                queueToken(lexer, TK_MINUS, start, 1);
+                queueToken(lexer, TK_GT, start + 1, 1);
+            } else {
+                queueToken(lexer, punctuatorKind(base + start, 2), start, 2);
+            }
+            continue;
+        }
+
+        // --- Single-character operators and delimiters ---
+        // '&', '|', '#', '\'', '.', '_', '\\' and other symbols on their own
+        // are dropped.
+        TokenKind kind = punctuatorKind(base + start, 1);
+        if (kind != TK_NONE) {
+            queueToken(lexer, kind, start, 1);
+        }
+    }
+
+    lexer->p = p;
+    lexer->line_start = line_start;
+    lexer->in_word = in_word;
+    if (lexer->queue_count == 0) {
+        return false;
+    }
+    popToken(lexer, token);
+    return true;
+}
+
+// Lex the whole source into a token buffer, with whitespace and comments in
+// trivia and identifiers interned into names; either may be NULL. Stops
+// early if an arena token buffer runs out of memory.
+void lexicalAnalyzer(const SourceBuffer* source, TokenBuffer* tokens, TriviaBuffer* trivia, InternTable* names) {
+    Lexer lexer;
+    Token token;
+    Token* slot;
+
+    initLexer(&lexer, source);
+    lexer.names = names;
+    lexer.trivia = trivia;
+    while (nextToken(&lexer, &token) && (slot = reserveToken(tokens)) != NULL) {
+        *slot = token;
+    }
+}
+
+#ifndef _WIN32
+// One slice of a parallel lex. Each slice is first lexed speculatively as if
+// it began in the plain state; stitching then checks that guess
+// against where the previous slice really ended. Slices keep whitespace and
+// comments as tokens, since stitching lines them up on newlines, and only
+// move them to the trivia table when copied out.
+typedef struct LexSlice {
+    const SourceBuffer* source;
+    uint64_t start;           // slice boundaries, just after a newline
+    uint64_t stop;
+    TokenBuffer tokens;       // speculative tokens
+    uint64_t end_offset;      // speculative state after the last step
+    TokenBuffer fixed;        // tokens re-lexed from the true state, if the guess was wrong
+    size_t adopt_from;        // tokens[adopt_from..] follow fixed
+    bool intern;              // identifiers get ids in names, then remap
+    InternTable names;        // the slice's own identifier ids
+    uint32_t* remap;          // slice id -> id in the caller's table
+    size_t token_count;       // significant tokens and trivia entries in the result
+    size_t trivia_count;
+    Token* output;
+    Trivia* trivia_output;    // NULL if the caller drops trivia
+} LexSlice;
+
+// Copy the significant tokens of tokens[0..count) to out, renaming
+// through remap (unless NULL), and the whitespace and comment tokens to trivia, merged into runs as
+// recordTrivia() merges them. Either output may be NULL to only count.
+// Returns the number of trivia entries; *significant gets the token count.
+static size_t splitTrivia(const char* text, const Token* tokens, size_t count, const uint32_t* remap,
+                          Token* out, Trivia* trivia, size_t* significant) {
+    size_t kept = 0, entries = 0;
+    uint64_t run_end = UINT64_MAX;   // where a whitespace byte would extend the last entry
+
+    for (size_t t = 0; t < count; t++) {
+        const Token* token = &tokens[t];
+        if (token->kind == TK_WHITE_SPACE || token->kind == TK_COMMENT) {
+            if (token->kind == TK_WHITE_SPACE && token->start == run_end) {
+                if (trivia != NULL) {
+                    trivia[entries - 1].length += token->length;
+                }
+            } else {
+                if (trivia != NULL) {
+                    memset(&trivia[entries], 0, sizeof(Trivia));
+                    trivia[entries].start = token->start;
+                    trivia[entries].length = token->length;
+                    trivia[entries].kind = token->kind;
+                }
+                entries++;
+            }
+            run_end = (token->kind == TK_WHITE_SPACE && text[token->start] != '\n') ?
+                      token->start + token->length : UINT64_MAX;
+            continue;
+        }
+        if (out != NULL) {
+            out[kept] = *token;
+            if (remap != NULL) {
+                out[kept].name_id = remap[token->name_id];
+            }
+        }
+        kept++;
+    }
+    *significant = kept;
+    return entries;
+}
+
+static void lexSliceTokens(Lexer* lexer, TokenBuffer* tokens) {
+    Token token;
+    while (nextToken(lexer, &token)) {
+        *reserveToken(tokens) = token;
+    }
+}
+
+static void* lexSliceWorker(void* argument) {
+    LexSlice* slice = (LexSlice*)argument;
+    Lexer lexer;
+
+    initLexerRange(&lexer, slice->source, slice->start, slice->stop);
+    lexer.trivia_tokens = true;
+    if (slice->intern) {
+        lexer.names = &slice->names;
+    }
+    lexSliceTokens(&lexer, &slice->tokens);
+    slice->end_offset = (uint64_t)(lexer.p - lexer.text.data);
+    slice->trivia_count = splitTrivia(slice->source->data, slice->tokens.tokens, slice->tokens.count,
+                                      NULL, NULL, NULL, &slice->token_count);
+    return NULL;
+}
+
+static void* copySliceWorker(void* argument) {
+    LexSlice* slice = (LexSlice*)argument;
+    const char* text = slice->source->data;
+    const uint32_t* remap = slice->intern ? slice->remap : NULL;
+    Trivia* trivia = slice->trivia_output;
+    size_t kept;
+
+    // The fixed tokens end on a newline, so no whitespace run spans both parts
+    size_t entries = splitTrivia(text, slice->fixed.tokens, slice->fixed.count, remap,
+                                 slice->output, trivia, &kept);
+    splitTrivia(text, slice->tokens.tokens + slice->adopt_from, slice->tokens.count - slice->adopt_from,
+                remap, slice->output + kept, trivia ? trivia + entries : NULL, &kept);
+    return NULL;
+}
+
+// Run worker on every slice, one thread each; a slice whose thread cannot be
+// started runs on this thread instead
+static void runSliceWorkers(LexSlice* slices, pthread_t* workers, int count, void* (*worker)(void*)) {
+    bool* started = (bool*)calloc((size_t)count, sizeof(bool));
+    if (!started) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++) {
+        started[i] = pthread_create(&workers[i], NULL, worker, &slices[i]) == 0;
+        if (!started[i]) {
+            worker(&slices[i]);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (started[i]) {
+            pthread_join(workers[i], NULL);
+        }
+    }
+    free(started);
+}
+
+// Index of the speculative token that starts at offset, or tokens->count
+static size_t findTokenAt(const TokenBuffer* tokens, uint64_t offset) {
+    size_t low = 0, high = tokens->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (tokens->tokens[mid].start < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < tokens->count && tokens->tokens[low].start == offset) ? low : tokens->count;
+}
+
+// Fit a slice to the offset where the slices before it really stopped, and
+// advance that offset past this slice. Tokens hold no line numbers, so a
+// slice that starts cleanly is taken as it is. One that does not (a token
+// ran into it) is re-lexed until both lexers emit the same newline token;
+// from there on they are in the same state and the speculative tokens are
+// reused.
+static void stitchSlice(LexSlice* slice, uint64_t* offset) {
+    if (*offset == slice->start) {
+        slice->adopt_from = 0;
+        *offset = slice->end_offset;
+        return;
+    }
+
+    const char* text = slice->source->data;
+    Lexer lexer;
+    Token token;
+
+    initLexerRange(&lexer, slice->source, *offset, slice->stop);
+    lexer.trivia_tokens = true;
+    if (slice->intern) {
+        lexer.names = &slice->names;
+    }
+    while (nextToken(&lexer, &token)) {
+        *reserveToken(&slice->fixed) = token;
+        if (token.kind != TK_WHITE_SPACE || text[token.start] != '\n') {
+            continue;
+        }
+        size_t match = findTokenAt(&slice->tokens, token.start);
+        if (match < slice->tokens.count && slice->tokens.tokens[match].kind == TK_WHITE_SPACE) {
+            // A newline token always ends a lexing step, so both lexers
+            // resume from the next byte
+            slice->adopt_from = match + 1;
+            *offset = slice->end_offset;
+            return;
+        }
+    }
+
+    // Never caught up with the speculation: the re-lexed tokens are the slice
+    slice->adopt_from = slice->tokens.count;
+    *offset = (uint64_t)(lexer.p - lexer.text.data);
+}
+
+// Recount what a stitched slice contributes when part of it was re-lexed:
+// the fixed tokens plus the speculative ones from adopt_from on
+static void countSliceOutput(LexSlice* slice) {
+    const char* text = slice->source->data;
+    size_t dropped, fixed;
+
+    if (slice->fixed.count == 0 && slice->adopt_from == 0) {
+        return;
+    }
+    size_t dropped_trivia = splitTrivia(text, slice->tokens.tokens, slice->adopt_from, NULL, NULL, NULL, &dropped);
+    size_t fixed_trivia = splitTrivia(text, slice->fixed.tokens, slice->fixed.count, NULL, NULL, NULL, &fixed);
+    slice->token_count = slice->token_count - dropped + fixed;
+    slice->trivia_count = slice->trivia_count - dropped_trivia + fixed_trivia;
+}
+
+// Give the slice's identifiers their ids in names, numbering new names in
+// the order they first appear, as a sequential lex would. Usually the slice
+// was lexed in one go, so its own ids are already in that order; otherwise
+// its final tokens are walked.
+static void remapSliceNames(LexSlice* slice, InternTable* names) {
+    uint32_t* remap = (uint32_t*)malloc((slice->names.count + 1) * sizeof(uint32_t));
+    if (!remap) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    slice->remap = remap;
+    remap[0] = 0;
+    if (slice->names.failed) {
+        names->failed = true;   // some of its identifiers were left without an id
+    }
+
+    if (slice->fixed.count == 0 && slice->adopt_from == 0) {
+        for (uint32_t id = 1; id <= slice->names.count; id++) {
+            const InternName* name = internedName(&slice->names, id);
+            remap[id] = internName(names, name->text, name->length);
+        }
+        return;
+    }
+
+    const char* text = slice->source->data;
+    memset(remap + 1, 0, slice->names.count * sizeof(uint32_t));
+    for (size_t t = 0; t < slice->fixed.count + (slice->tokens.count - slice->adopt_from); t++) {
+        const Token* token = t < slice->fixed.count ? &slice->fixed.tokens[t] :
+                             &slice->tokens.tokens[slice->adopt_from + (t - slice->fixed.count)];
+        if (token->name_id != 0 && remap[token->name_id] == 0) {
+            remap[token->name_id] = internName(names, text + token->start, token->length);
+        }
+    }
+}
+
+// Offset just past the first newline at or after offset that is code, not
+// part of a string or comment, or the size of the source
+static uint64_t nextCodeLine(const StructureIndex* index, const char* text, uint64_t offset) {
+    const char* p = text + offset;
+    const char* end = text + index->size;
+    while ((p = memchr(p, '\n', end - p)) != NULL) {
+        uint64_t at = (uint64_t)(p - text);
+        if (!isLiteralByte(index, at)) {
+            return at + 1;
+        }
+        p++;
+    }
+    return index->size;
+}
+
+// Lex an in-memory source on up to threads threads, with exactly the result
+// of lexicalAnalyzer(). The structural index finds newlines that are code,
+// and the source is cut into slices just after them, so every slice starts
+// in the plain state. The slices are lexed in parallel, stitched together in
+// order (stitching still re-lexes a slice that does not start cleanly) and
+// copied into tokens in parallel. A tally-only trivia buffer is filled by a
+// sequential lex.
+void lexicalAnalyzerParallel(const SourceBuffer* source, TokenBuffer* tokens, TriviaBuffer* trivia,
+                             InternTable* names, int threads) {
+    if (threads <= 1 || source->size == 0 || (trivia != NULL && trivia->tally_only)) {
+        lexicalAnalyzer(source, tokens, trivia, names);
+        return;
+    }
+
+    LexSlice* slices = (LexSlice*)calloc((size_t)threads, sizeof(LexSlice));
+    pthread_t* workers = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    if (!slices || !workers) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+
+    // The shared tables are filled once here, before the workers read them
+    initLexerTables();
+
+    StructureIndex index;
+    buildStructureIndex(&index, source->data, source->size);
+
+    uint64_t start = 0;
+    for (int i = 0; i < threads; i++) {
+        uint64_t stop = source->size * (uint64_t)(i + 1) / (uint64_t)threads;
+        if (stop < start) {
+            stop = start;
+        }
+        if (stop < source->size) {
+            stop = nextCodeLine(&index, source->data, stop);
+        }
+        slices[i].source = source;
+        slices[i].start = start;
+        slices[i].stop = stop;
+        initTokenBuffer(&slices[i].tokens);
+        initTokenBuffer(&slices[i].fixed);
+        slices[i].intern = names != NULL;
+        if (slices[i].intern) {
+            if (!initInternTable(&slices[i].names)) {
+                printf("Memory allocation failed!\n");
+                exit(1);
+            }
+        }
+        start = stop;
+    }
+    freeStructureIndex(&index);
+
+    runSliceWorkers(slices, workers, threads, lexSliceWorker);
+
+    uint64_t offset = 0;
+    size_t total = 0, total_trivia = 0;
+    for (int i = 0; i < threads; i++) {
+        stitchSlice(&slices[i], &offset);
+        countSliceOutput(&slices[i]);
+        if (names != NULL) {
+            remapSliceNames(&slices[i], names);
+        }
+        total += slices[i].token_count;
+        total_trivia += slices[i].trivia_count;
+    }
+
+    // An arena buffer out of memory gets no tokens; its arena says so
+    bool room = (tokens->count + total <= tokens->capacity || growTokenBuffer(tokens, tokens->count + total)) &&
+                (trivia == NULL || trivia->count + total_trivia <= trivia->capacity ||
+                 growTriviaBuffer(trivia, trivia->count + total_trivia));
+    if (!room) {
+        total = 0;
+        total_trivia = 0;
+    }
+    Token* out = tokens->tokens + tokens->count;
+    Trivia* trivia_out = trivia != NULL ? trivia->trivia + trivia->count : NULL;
+    for (int i = 0; i < threads; i++) {
+        slices[i].output = out;
+        slices[i].trivia_output = trivia_out;
+        out += slices[i].token_count;
+        if (trivia_out != NULL) {
+            trivia_out += slices[i].trivia_count;
+        }
+    }
+    if (room) {
+        runSliceWorkers(slices, workers, threads, copySliceWorker);
+    }
+    tokens->count += total;
+    if (trivia != NULL) {
+        trivia->count += total_trivia;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        freeTokenBuffer(&slices[i].tokens);
+        freeTokenBuffer(&slices[i].fixed);
+        if (names != NULL) {
+            freeInternTable(&slices[i].names);
+            free(slices[i].remap);
+        }
+    }
+    free(workers);
+    free(slices);
+}
+#else
+// No thread support on this platform: lex sequentially
+void lexicalAnalyzerParallel(const SourceBuffer* source, TokenBuffer* tokens, TriviaBuffer* trivia,
+                             InternTable* names, int threads) {
+    (void)threads;
+    lexicalAnalyzer(source, tokens, trivia, names);
+}
+#endif
+
+void initTokenBuffer(TokenBuffer* tokens) {
+    tokens->tokens = NULL;
+    tokens->count = 0;
+    tokens->capacity = 0;
+    tokens->arena = NULL;
+}
+
+// Token buffer whose storage comes from arena and goes when it is reset
+void initArenaTokenBuffer(TokenBuffer* tokens, Arena* arena) {
+    initTokenBuffer(tokens);
+    tokens->arena = arena;
+}
+
+// Resize the buffer to hold capacity tokens. Returns false, keeping the
+// tokens it has, when an arena buffer cannot grow.
+bool growTokenBuffer(TokenBuffer* tokens, size_t capacity) {
+    Token* grown;
+    if (tokens->arena != NULL) {
+        grown = (Token*)arenaGrow(tokens->arena, tokens->tokens, tokens->capacity * sizeof(Token),
+                                  capacity * sizeof(Token));
+        if (!grown) {
+            return false;
+        }
+    } else {
+        grown = (Token*)realloc(tokens->tokens, capacity * sizeof(Token));
+        if (!grown) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+    }
+    tokens->tokens = grown;
+    tokens->capacity = capacity;
+    return true;
+}
+
+// Reserve the next slot at the end of the buffer (amortised O(1)), or NULL
+// when an arena buffer is out of memory
+Token* reserveToken(TokenBuffer* tokens) {
+    if (tokens->count == tokens->capacity &&
+        !growTokenBuffer(tokens, tokens->capacity ? tokens->capacity * 2 : 256)) {
+        return NULL;
+    }
+    return &tokens->tokens[tokens->count++];
+}
+
+void freeTokenBuffer(TokenBuffer* tokens) {
+    Arena* arena = tokens->arena;
+    if (arena == NULL) {
+        free(tokens->tokens);
+    }
+    initArenaTokenBuffer(tokens, arena);
+}
+
+void initTriviaBuffer(TriviaBuffer* trivia) {
+    trivia->trivia = NULL;
+    trivia->count = 0;
+    trivia->capacity = 0;
+    trivia->arena = NULL;
+    trivia->tally_only = false;
+    trivia->whitespace = 0;
+    trivia->comments = 0;
+}
+
+// Trivia buffer whose storage comes from arena and goes when it is reset
+void initArenaTriviaBuffer(TriviaBuffer* trivia, Arena* arena) {
+    initTriviaBuffer(trivia);
+    trivia->arena = arena;
+}
+
+// Trivia buffer that only counts, so it stays empty however long the input
+void initTriviaTally(TriviaBuffer* trivia) {
+    initTriviaBuffer(trivia);
+    trivia->tally_only = true;
+}
+
+// Resize the buffer to hold capacity entries. Returns false, keeping the
+// entries it has, when an arena buffer cannot grow.
+bool growTriviaBuffer(TriviaBuffer* trivia, size_t capacity) {
+    Trivia* grown;
+    if (trivia->arena != NULL) {
+        grown = (Trivia*)arenaGrow(trivia->arena, trivia->trivia, trivia->capacity * sizeof(Trivia),
+                                   capacity * sizeof(Trivia));
+        if (!grown) {
+            return false;
+        }
+    } else {
+        grown = (Trivia*)realloc(trivia->trivia, capacity * sizeof(Trivia));
+        if (!grown) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+    }
+    trivia->trivia = grown;
+    trivia->capacity = capacity;
+    return true;
+}
+
+// Record whitespace or a comment. With extend set, whitespace right after a
+// whitespace entry is added to that entry instead of starting a new one.
+void appendTrivia(TriviaBuffer* trivia, TokenKind kind, uint64_t start, size_t length, bool extend) {
+    if (trivia->tally_only) {
+        if (kind == TK_WHITE_SPACE) {
+            trivia->whitespace += length;
+        } else {
+            trivia->comments++;
+        }
+        return;
+    }
+    if (extend && kind == TK_WHITE_SPACE && trivia->count > 0) {
+        Trivia* last = &trivia->trivia[trivia->count - 1];
+        if (last->kind == TK_WHITE_SPACE && last->start + last->length == start &&
+            last->length + (uint64_t)length <= UINT32_MAX) {
+            last->length += (uint32_t)length;
+            return;
+        }
+    }
+    if (trivia->count == trivia->capacity &&
+        !growTriviaBuffer(trivia, trivia->capacity ? trivia->capacity * 2 : 256)) {
+        return;   // the arena records that the entry was lost
+    }
+    Trivia* entry = &trivia->trivia[trivia->count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->start = start;
+    entry->length = (uint32_t)length;
+    entry->kind = (uint8_t)kind;
+}
+
+void freeTriviaBuffer(TriviaBuffer* trivia) {
+    Arena* arena = trivia->arena;
+    bool tally_only = trivia->tally_only;
+    if (arena == NULL) {
+        free(trivia->trivia);
+    }
+    initArenaTriviaBuffer(trivia, arena);
+    trivia->tally_only = tally_only;
+}
+
+const char* tokenTypeToString(TokenType type) {
+    switch (type) {
+        case IDENTIFIER: return "IDENTIFIER";
+        case OPERATION: return "OPERATION";
+        case KEYWORDS: return "KEYWORDS";
+        case RESERVED_WORDS: return "RESERVED_WORDS";
+        case CONSTANT: return "CONSTANT";
+        case NOISE_WORDS: return "NOISE_WORDS";
+        case COMMENT: return "COMMENT";
+        case WHITE_SPACE: return "WHITE_SPACE";
+        case DELIMITER: return "DELIMITER";
+        default: return "UNKNOWN";
+    }
+}
+
+void displayTokens(const TokenBuffer* tokens, const SourceBuffer* source) {
+    printf("Token Stream:\n");
+    for (size_t t = 0; t < tokens->count; t++) {
+        const Token* token = &tokens->tokens[t];
+        printf("<%s, \"%.*s\">\n", tokenTypeToString(token->type),
+               (int)token->length, source->data + token->start);
+    }
+    printf("NULL\n");
+}
+
+// A table holding line 1, starting at offset 0, or an empty failed one
+void initLineIndex(LineIndex* lines) {
+    lines->capacity = 1024;
+    lines->starts = (uint64_t*)malloc(lines->capacity * sizeof(uint64_t));
+    lines->count = 0;
+    lines->first_line = 1;
+    lines->cut_line = 0;
+    lines->cut_tabs = 0;
+    lines->failed = lines->starts == NULL;
+    if (lines->failed) {
+        lines->capacity = 0;
+        return;
+    }
+    lines->starts[lines->count++] = 0;
+}
+
+// Once the table cannot grow, later lines are left out and failed is set
+void appendLineStart(LineIndex* lines, uint64_t offset) {
+    if (lines->failed) {
+        return;
+    }
+    if (lines->count == lines->capacity) {
+        size_t capacity = lines->capacity * 2;
+        uint64_t* grown = (uint64_t*)realloc(lines->starts, capacity * sizeof(uint64_t));
+        if (!grown) {
+            lines->failed = true;
+            return;
+        }
+        lines->starts = grown;
+        lines->capacity = capacity;
+    }
+    lines->starts[lines->count++] = offset;
+}
+
+// Line starts of a whole in-memory source, found with memchr
+void buildLineIndex(const SourceBuffer* source, LineIndex* lines) {
+    const char* p = source->data;
+    const char* end = source->data + source->size;
+
+    initLineIndex(lines);
+    while (!lines->failed && p < end && (p = memchr(p, '\n', end - p)) != NULL) {
+        p++;
+        appendLineStart(lines, (uint64_t)(p - source->data));
+    }
+}
+
+void freeLineIndex(LineIndex* lines) {
+    free(lines->starts);
+    lines->starts = NULL;
+    lines->count = 0;
+    lines->capacity = 0;
+}
+
+// Header, token array, source text, line starts and trivia, each section
+// 8-byte aligned
+static void writeTokenStream(FILE* file, const TokenBuffer* tokens, const TriviaBuffer* trivia,
+                             const SourceBuffer* source) {
+    static const char padding[8] = {0};
+    LineIndex lines;
+    TokenStreamHeader header;
+
+    buildLineIndex(source, &lines);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TOKEN_STREAM_MAGIC, sizeof(header.magic));
+    header.version = TOKEN_STREAM_VERSION;
+    header.token_size = sizeof(Token);
+    header.token_count = tokens->count;
+    header.text_size = source->size;
+    header.line_count = lines.count;
+    header.tokens_offset = sizeof(header);
+    header.text_offset = header.tokens_offset + tokens->count * sizeof(Token);
+    header.lines_offset = TOKEN_STREAM_ALIGN(header.text_offset + source->size);
+    header.trivia_count = trivia != NULL ? trivia->count : 0;
+    header.trivia_offset = header.lines_offset + lines.count * sizeof(uint64_t);
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(tokens->tokens, sizeof(Token), tokens->count, file);
+    fwrite(source->data, 1, source->size, file);
+    fwrite(padding, 1, header.lines_offset - (header.text_offset + source->size), file);
+    fwrite(lines.starts, sizeof(uint64_t), lines.count, file);
+    if (trivia != NULL) {
+        fwrite(trivia->trivia, sizeof(Trivia), trivia->count, file);
+    }
+
+    freeLineIndex(&lines);
+}
+
+// One "TYPE lexeme" line, with whitespace spelled out
+static void writeSymbolTableEntry(FILE* file, TokenType type, const char* lexeme, size_t length) {
+    fprintf(file, "%s ", tokenTypeToString(type));
+    
+    // Write lexeme character by character
+    for (size_t i = 0; i < length; i++) {
+        char c = lexeme[i];
+        if (type == WHITE_SPACE && c != '\n' && c != '\t') {
+            c = ' ';  // '\r', '\v' and '\f' are written as plain spaces
+        }
+        if (c == '\n') {
+            fprintf(file, "\\n");
+        } else if (c == '\t') {
+            fprintf(file, "\\t");
+        } else if (c == ' ') {
+            fprintf(file, "_");
+        } else {
+            fputc(c, file);
+        }
+    }
+    
+    fprintf(file, "\n");
+}
+
+// The text format lists whitespace and comments in place, one line per
+// whitespace byte, so trivia (if not NULL) is merged back in by offset
+void writeSymbolTableToFile(const TokenBuffer* tokens, const TriviaBuffer* trivia, const SourceBuffer* source,
+                            const char* filename, SymbolTableFormat format) {
+    FILE* file = fopen(filename, format == SYMBOL_TABLE_BINARY ? "wb" : "w");
+    if (file == NULL) {
+        perror("Error opening output file");
+        return;
+    }
+
+    if (format == SYMBOL_TABLE_BINARY) {
+        writeTokenStream(file, tokens, trivia, source);
+        fclose(file);
+        printf("Token stream written to '%s' successfully!\n", filename);
+        return;
+    }
+
+    // Write each token in simple format
+    size_t trivia_count = trivia != NULL ? trivia->count : 0;
+    size_t t = 0, v = 0;
+    while (t < tokens->count || v < trivia_count) {
+        if (v < trivia_count && (t == tokens->count || trivia->trivia[v].start < tokens->tokens[t].start)) {
+            const Trivia* entry = &trivia->trivia[v++];
+            const char* lexeme = source->data + entry->start;
+            if (entry->kind == TK_COMMENT) {
+                writeSymbolTableEntry(file, COMMENT, lexeme, entry->length);
+            } else {
+                for (uint32_t i = 0; i < entry->length; i++) {
+                    writeSymbolTableEntry(file, WHITE_SPACE, lexeme + i, 1);
+                }
+            }
+        } else {
+            const Token* temp = &tokens->tokens[t++];
+            writeSymbolTableEntry(file, (TokenType)temp->type, source->data + temp->start, temp->length);
+        }
+    }
+    
+    fclose(file);
+    printf("Symbol table written to '%s' successfully!\n", filename);
+}
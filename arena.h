@@ -0,0 +1,151 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define ARENA_BLOCK_SIZE (1 << 16)
+#define ARENA_ALIGN(size) (((size) + sizeof(max_align_t) - 1) & ~(sizeof(max_align_t) - 1))
+
+// Bump allocator: allocations are never freed one by one, only all at once
+// by arenaReset() or freeArena(). Each new block is at least as big as all
+// the earlier ones together, so a reset arena keeps only its largest block
+// and the next file of similar size fits in it without calling malloc.
+// When malloc fails the allocation returns NULL and failed stays set until
+// the next reset, so a driver can report the file instead of exiting.
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size;
+    size_t used;
+    max_align_t data[];       // keeps allocations suitably aligned
+} ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* head;         // block being filled; older blocks follow
+    size_t used;              // bytes handed out since the last reset
+    size_t high_water;        // most bytes ever in use at once
+    size_t reserved;          // bytes held in blocks
+    bool failed;              // an allocation failed since the last reset
+} Arena;
+
+static inline void initArena(Arena* arena) {
+    arena->head = NULL;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->reserved = 0;
+    arena->failed = false;
+}
+
+static inline void* arenaAlloc(Arena* arena, size_t size) {
+    ArenaBlock* block = arena->head;
+
+    size = ARENA_ALIGN(size);
+    if (block == NULL || block->size - block->used < size) {
+        size_t block_size = arena->reserved > ARENA_BLOCK_SIZE ? arena->reserved : ARENA_BLOCK_SIZE;
+        if (block_size < size) {
+            block_size = size;
+        }
+        block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + block_size);
+        if (block == NULL) {
+            arena->failed = true;
+            return NULL;
+        }
+        block->next = arena->head;
+        block->size = block_size;
+        block->used = 0;
+        arena->head = block;
+        arena->reserved += block_size;
+    }
+    void* memory = (char*)block->data + block->used;
+    block->used += size;
+    arena->used += size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return memory;
+}
+
+// Grow the allocation at memory from old_size to new_size bytes. The latest
+// allocation grows in place when its block has room, and a block holding
+// nothing else is resized with realloc; anything else is copied, and its
+// old space is only reclaimed by the next reset. Returns NULL, leaving the
+// old allocation as it was, when out of memory.
+static inline void* arenaGrow(Arena* arena, void* memory, size_t old_size, size_t new_size) {
+    ArenaBlock* block = arena->head;
+    bool latest;
+
+    old_size = ARENA_ALIGN(old_size);
+    new_size = ARENA_ALIGN(new_size);
+    latest = memory != NULL && block != NULL &&
+             (char*)memory + old_size == (char*)block->data + block->used;
+
+    if (latest && memory == (void*)block->data && block->size < new_size) {
+        size_t block_size = block->size * 2 > new_size ? block->size * 2 : new_size;
+        block = (ArenaBlock*)realloc(block, sizeof(ArenaBlock) + block_size);
+        if (block == NULL) {
+            arena->failed = true;
+            return NULL;
+        }
+        arena->reserved += block_size - block->size;
+        block->size = block_size;
+        arena->head = block;
+        memory = block->data;
+    }
+    if (latest && block->size - block->used >= new_size - old_size) {
+        block->used += new_size - old_size;
+        arena->used += new_size - old_size;
+        if (arena->used > arena->high_water) {
+            arena->high_water = arena->used;
+        }
+        return memory;
+    }
+
+    void* grown = arenaAlloc(arena, new_size);
+    if (grown != NULL && memory != NULL) {
+        memcpy(grown, memory, old_size);
+    }
+    return grown;
+}
+
+// Release everything allocated so far but keep the largest block for reuse
+static inline void arenaReset(Arena* arena) {
+    ArenaBlock* largest = NULL;
+
+    while (arena->head != NULL) {
+        ArenaBlock* next = arena->head->next;
+        if (largest == NULL || arena->head->size > largest->size) {
+            if (largest != NULL) {
+                free(largest);
+            }
+            largest = arena->head;
+        } else {
+            free(arena->head);
+        }
+        arena->head = next;
+    }
+    if (largest != NULL) {
+        largest->next = NULL;
+        largest->used = 0;
+        arena->reserved = largest->size;
+    } else {
+        arena->reserved = 0;
+    }
+    arena->head = largest;
+    arena->used = 0;
+    arena->failed = false;
+}
+
+static inline void freeArena(Arena* arena) {
+    while (arena->head != NULL) {
+        ArenaBlock* next = arena->head->next;
+        free(arena->head);
+        arena->head = next;
+    }
+    arena->used = 0;
+    arena->reserved = 0;
+}
+
+#endif
@@ -0,0 +1,181 @@
+// Times expression parsing: the old seven-level descent ladder against
+// parseExpr() and its binding_powers table, on the same token array.
+//
+//     gcc -O2 -pthread -DLEXC_DRIVER -o expr_bench bench/expr_bench.c RevisedFinal.c
+//     ./expr_bench [statements] [repetitions]
+//
+// The input is generated from a fixed seed, so every run times the same
+// tokens: expression statements using every binary operator the ladder
+// knows, unary and postfix operators and nested parentheses. It is lexed
+// once, then each parser runs over it repetitions times and the best run
+// counts. Both must take every token and report no errors.
+#include <time.h>
+
+#include "../syntax_analyzer2.c"
+#include "old_expression_ladder.h"
+
+static const char* const binary_operators[] = {
+    "||", "&&", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%",
+};
+#define BINARY_COUNT (sizeof(binary_operators) / sizeof(binary_operators[0]))
+
+static const char* const prefix_operators[] = { "-", "!", "++", "--", "+" };
+#define PREFIX_COUNT (sizeof(prefix_operators) / sizeof(prefix_operators[0]))
+
+static unsigned long long seed = 88172645463325252ull;
+
+static unsigned nextRandom(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned)(seed >> 32);
+}
+
+static double now(void) {
+    struct timespec t;
+    timespec_get(&t, TIME_UTC);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct TextBuffer {
+    char* data;
+    size_t size;
+    size_t capacity;
+} TextBuffer;
+
+static void appendText(TextBuffer* text, const char* s) {
+    size_t n = strlen(s);
+    if (text->size + n > text->capacity) {
+        size_t capacity = (text->size + n) * 2;
+        char* grown = (char*)realloc(text->data, capacity);
+        if (!grown) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        text->data = grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->size, s, n);
+    text->size += n;
+}
+
+static void makeExpr(TextBuffer* text, int depth);
+
+// One operand, sometimes with a prefix or postfix operator, and
+// parenthesized less often the deeper it is
+static void makeOperand(TextBuffer* text, int depth) {
+    char word[32];
+    if (nextRandom() % 6 == 0) {
+        appendText(text, prefix_operators[nextRandom() % PREFIX_COUNT]);
+    }
+    if (depth < 4 && nextRandom() % (depth + 3) == 0) {
+        appendText(text, "(");
+        makeExpr(text, depth + 1);
+        appendText(text, ")");
+    } else if (nextRandom() % 3 == 0) {
+        snprintf(word, sizeof(word), "%u", nextRandom() % 1000);
+        appendText(text, word);
+    } else {
+        snprintf(word, sizeof(word), "v%u", nextRandom() % 200);
+        appendText(text, word);
+        if (nextRandom() % 10 == 0) {
+            appendText(text, nextRandom() % 2 ? "++" : "--");
+        }
+    }
+}
+
+// Two to eight operands joined by binary operators
+static void makeExpr(TextBuffer* text, int depth) {
+    int operands = 2 + (int)(nextRandom() % 7);
+    makeOperand(text, depth);
+    for (int i = 1; i < operands; i++) {
+        appendText(text, " ");
+        appendText(text, binary_operators[nextRandom() % BINARY_COUNT]);
+        appendText(text, " ");
+        makeOperand(text, depth);
+    }
+}
+
+// Parses every statement of the token array with parse; returns the seconds
+// taken and leaves the errors and the tokens taken in the parser
+static double timeParse(Parser* parser, Arena* arena, const TokenBuffer* tokens, const SourceBuffer* source,
+                        void (*parse)(Parser*)) {
+    arenaReset(arena);
+    loadTokens(parser, tokens->tokens, tokens->count, NULL, 0, source->data, source->size, NULL, 0);
+    parser->current_token = fetchToken(parser);
+    double start = now();
+    while (parser->current_token != NULL) {
+        parse(parser);
+        if (!match(parser, TK_SEMICOLON)) {
+            recordError(parser, "Missing ';' after expression");
+            advance(parser);
+        }
+    }
+    return now() - start;
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 50000;
+    int repetitions = argc > 2 ? atoi(argv[2]) : 11;
+    TextBuffer text = { NULL, 0, 0 };
+    SourceBuffer source;
+    TokenBuffer tokens;
+    TriviaBuffer trivia;
+    InternTable names;
+    Arena arena;
+    Parser parser;
+    double best_ladder = 1e30, best_climbing = 1e30;
+
+    if (statements == 0 || repetitions <= 0) {
+        printf("Usage: %s [statements] [repetitions]\n", argv[0]);
+        return 1;
+    }
+    for (size_t i = 0; i < statements; i++) {
+        makeExpr(&text, 0);
+        appendText(&text, ";\n");
+    }
+    source.data = text.data;
+    source.size = text.size;
+    source.mapped = false;
+
+    initTokenBuffer(&tokens);
+    initTriviaBuffer(&trivia);
+    initInternTable(&names);
+    lexicalAnalyzer(&source, &tokens, &trivia, &names);
+
+    initArena(&arena);
+    initParser(&parser, &arena);
+    for (int r = 0; r < repetitions; r++) {
+        double t = timeParse(&parser, &arena, &tokens, &source, oldParseExpr);
+        if (parser.error_count != 0 || parser.token_array.next != tokens.count) {
+            printf("The ladder reported %d error(s) on the generated input\n", parser.error_count);
+            return 1;
+        }
+        if (t < best_ladder) {
+            best_ladder = t;
+        }
+        t = timeParse(&parser, &arena, &tokens, &source, parseExpr);
+        if (parser.error_count != 0 || parser.token_array.next != tokens.count) {
+            printf("parseExpr reported %d error(s) on the generated input\n", parser.error_count);
+            return 1;
+        }
+        if (t < best_climbing) {
+            best_climbing = t;
+        }
+    }
+
+    printf("%zu statements, %zu bytes, %zu tokens, best of %d runs\n",
+           statements, source.size, tokens.count, repetitions);
+    printf("  seven-level ladder:    %.1f ms (%.1f ns/token)\n",
+           best_ladder * 1e3, best_ladder * 1e9 / (double)tokens.count);
+    printf("  precedence climbing:   %.1f ms (%.1f ns/token)\n",
+           best_climbing * 1e3, best_climbing * 1e9 / (double)tokens.count);
+
+    freeParseStack(&parser);
+    freeArena(&arena);
+    freeTokenBuffer(&tokens);
+    freeTriviaBuffer(&trivia);
+    freeInternTable(&names);
+    free(text.data);
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Times keyword classification: the old state machine, with the strncmp
+// chain the lexer ran on its string result, against lookupKeyword() and
+// the KEYWORD_TABLE hash in tokens.h.
+//
+//     gcc -O2 -o keyword_bench bench/keyword_bench.c
+//     ./keyword_bench [words] [repetitions]
+//
+// The words are generated from a fixed seed, so every run times the same
+// input: a quarter keywords, a quarter keywords with a letter added, a
+// quarter with the last letter dropped and a quarter random identifiers.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../tokens.h"
+#include "old_keyword_automaton.h"
+
+static const TokenKind keyword_kinds[] = {
+#define KEYWORD_KIND(kind, spelling, type, flags) kind,
+    KEYWORD_TABLE(KEYWORD_KIND)
+#undef KEYWORD_KIND
+};
+#define KEYWORD_COUNT (sizeof(keyword_kinds) / sizeof(keyword_kinds[0]))
+
+static unsigned long long seed = 88172645463325252ull;
+
+static unsigned nextRandom(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned)(seed >> 32);
+}
+
+static double now(void) {
+    struct timespec t;
+    timespec_get(&t, TIME_UTC);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+// One word of at most 15 letters into word, NUL-terminated; returns its length
+static size_t makeWord(char* word) {
+    unsigned pick = nextRandom() % 4;
+    size_t len;
+    if (pick < 3) {
+        TokenKind kind = keyword_kinds[nextRandom() % KEYWORD_COUNT];
+        len = token_kind_length[kind];
+        memcpy(word, token_kind_spelling[kind], len);
+        if (pick == 1) {
+            word[len++] = (char)('a' + nextRandom() % 26);
+        } else if (pick == 2 && len > 1) {
+            len--;
+        }
+    } else {
+        len = 1 + nextRandom() % 12;
+        for (size_t i = 0; i < len; i++) {
+            word[i] = (char)('a' + nextRandom() % 26);
+        }
+    }
+    word[len] = '\0';
+    return len;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 60000;
+    int repetitions = argc > 2 ? atoi(argv[2]) : 200;
+    char* text = (char*)malloc(count * 16);
+    size_t* lengths = (size_t*)malloc(count * sizeof(size_t));
+    volatile unsigned long sink = 0;
+    size_t keywords = 0;
+
+    if (!text || !lengths || count == 0 || repetitions <= 0) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    initKeywordTable();
+    for (size_t i = 0; i < count; i++) {
+        lengths[i] = makeWord(text + i * 16);
+        if (lookupKeyword(text + i * 16, lengths[i]) != TK_IDENTIFIER) {
+            keywords++;
+        }
+    }
+
+    double t0 = now();
+    for (int r = 0; r < repetitions; r++) {
+        for (size_t i = 0; i < count; i++) {
+            const char* result = check_keyword_or_reserved(text + i * 16);
+            if (strncmp(result, "KEYWORD", 8) == 0) {
+                sink += KEYWORDS;
+            } else if (strncmp(result, "RESERVED_WORD", 14) == 0) {
+                sink += RESERVED_WORDS;
+            } else if (strncmp(result, "NOISE_WORD", 10) == 0) {
+                sink += NOISE_WORDS;
+            }
+        }
+    }
+    double t1 = now();
+    for (int r = 0; r < repetitions; r++) {
+        for (size_t i = 0; i < count; i++) {
+            sink += token_kind_type[lookupKeyword(text + i * 16, lengths[i])];
+        }
+    }
+    double t2 = now();
+
+    double words = (double)count * repetitions;
+    printf("%zu words (%zu keywords), %d repetitions\n", count, keywords, repetitions);
+    printf("  state machine + strncmp: %.1f ns/word\n", (t1 - t0) * 1e9 / words);
+    printf("  hash table lookup:       %.1f ns/word\n", (t2 - t1) * 1e9 / words);
+    free(text);
+    free(lengths);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#ifndef OLD_EXPRESSION_LADDER_H
+#define OLD_EXPRESSION_LADDER_H
+
+// The seven-level recursive descent ladder that parseExpr() replaced, kept
+// only for bench/expr_bench.c. It is the code as it was before the change,
+// except that parseExpr and parsePrimaryExpr are renamed so as not to clash
+// with the parser's own. Include after syntax_analyzer2.c.
+
+void oldParseExpr(Parser* parser);
+void parseLogicalOrExpr(Parser* parser);
+void parseLogicalAndExpr(Parser* parser);
+void parseEqualityExpr(Parser* parser);
+void parseRelationalExpr(Parser* parser);
+void parseAdditiveExpr(Parser* parser);
+void parseMultiplicativeExpr(Parser* parser);
+void parseUnaryExpr(Parser* parser);
+void parsePostfixExpr(Parser* parser);
+void oldParsePrimaryExpr(Parser* parser);
+
+void oldParseExpr(Parser* parser) {
+    parseLogicalOrExpr(parser);
+}
+
+void parseLogicalOrExpr(Parser* parser) {
+    parseLogicalAndExpr(parser);
+    while (match(parser, TK_OR)) {
+        parseLogicalAndExpr(parser);
+    }
+}
+
+void parseLogicalAndExpr(Parser* parser) {
+    parseEqualityExpr(parser);
+    while (match(parser, TK_AND)) {
+        parseEqualityExpr(parser);
+    }
+}
+
+void parseEqualityExpr(Parser* parser) {
+    parseRelationalExpr(parser);
+    while (match(parser, TK_EQ) || match(parser, TK_NE)) {
+        parseRelationalExpr(parser);
+    }
+}
+
+void parseRelationalExpr(Parser* parser) {
+    parseAdditiveExpr(parser);
+    while (match(parser, TK_LT) || match(parser, TK_GT) || 
+           match(parser, TK_LE) || match(parser, TK_GE)) {
+        parseAdditiveExpr(parser);
+    }
+}
+
+void parseAdditiveExpr(Parser* parser) {
+    parseMultiplicativeExpr(parser);
+    while (match(parser, TK_PLUS) || match(parser, TK_MINUS)) {
+        parseMultiplicativeExpr(parser);
+    }
+}
+
+void parseMultiplicativeExpr(Parser* parser) {
+    parseUnaryExpr(parser);
+    while (match(parser, TK_STAR) || match(parser, TK_SLASH) || match(parser, TK_PERCENT)) {
+        parseUnaryExpr(parser);
+    }
+}
+
+void parseUnaryExpr(Parser* parser) {
+    if (match(parser, TK_PLUS) || match(parser, TK_MINUS) || 
+        match(parser, TK_NOT) || match(parser, TK_INC) || match(parser, TK_DEC)) {
+        parseUnaryExpr(parser);
+    } else {
+        parsePostfixExpr(parser);
+    }
+}
+
+void parsePostfixExpr(Parser* parser) {
+    oldParsePrimaryExpr(parser);
+    while (match(parser, TK_INC) || match(parser, TK_DEC)) {
+        // Postfix operators handled
+    }
+}
+
+void oldParsePrimaryExpr(Parser* parser) {
+    if (matchType(parser, IDENTIFIER)) {
+        return;
+    }
+    else if (matchType(parser, CONSTANT)) {
+        return;
+    }
+    else if (checkType(parser, RESERVED_WORDS)) {
+        advance(parser);
+        return;
+    }
+    else if (match(parser, TK_LPAREN)) {
+        oldParseExpr(parser);
+        if (!match(parser, TK_RPAREN)) {
+            recordError(parser, "Missing ')' in expression");
+        }
+        return;
+    }
+    else {
+        recordError(parser, "Invalid expression");
+        // Try to recover
+        advance(parser);
+    }
+}
+
+#endif
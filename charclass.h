@@ -0,0 +1,173 @@
+// Character classes for the lexer (RevisedFinal.c), from a 256-entry table
+// instead of the locale-dependent <ctype.h> calls, and kernels that find the
+// end of a word or a whitespace run 16 or 32 bytes at a time. The classes
+// are those of the "C" locale; bytes 128-255 are in none of them.
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHARCLASS_X86 1
+#include <immintrin.h>
+#endif
+
+#define CC_SPACE  0x01   // ' ', \t, \n, \v, \f, \r
+#define CC_BLANK  0x02   // whitespace other than \n: one run of these is one trivia entry
+#define CC_PUNCT  0x04   // printable, not a letter, digit or space
+#define CC_DIGIT  0x08
+#define CC_ALPHA  0x10
+#define CC_ALNUM  (CC_DIGIT | CC_ALPHA)
+#define CC_DELIMITER (CC_SPACE | CC_PUNCT)   // ends a word
+
+static uint8_t char_class[256];
+
+#define IS_CLASS(c, classes) ((char_class[(unsigned char)(c)] & (classes)) != 0)
+
+// First byte in [p, end) that ends a word (whitespace or punctuation), or end
+static inline const char* findDelimiterScalar(const char* p, const char* end) {
+    while (p < end && !IS_CLASS(*p, CC_DELIMITER)) {
+        p++;
+    }
+    return p;
+}
+
+// First byte in [p, end) that is not whitespace other than \n, or end
+static inline const char* skipBlanksScalar(const char* p, const char* end) {
+    while (p < end && IS_CLASS(*p, CC_BLANK)) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef CHARCLASS_X86
+// Lanes of v in [lo, hi] as 0xFF, others 0. SSE2 has no unsigned byte
+// compare, so this tests min(v - lo, hi - lo) == v - lo.
+__attribute__((target("sse2")))
+static inline __m128i inRange16(__m128i v, char lo, char hi) {
+    __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8((char)(hi - lo))), offset);
+}
+
+// Bytes 9-13, 32-47, 58-64, 91-96 and 123-126: exactly CC_DELIMITER
+__attribute__((target("sse2")))
+static inline __m128i delimiters16(__m128i v) {
+    return _mm_or_si128(_mm_or_si128(inRange16(v, 9, 13), inRange16(v, 32, 47)),
+                        _mm_or_si128(_mm_or_si128(inRange16(v, 58, 64), inRange16(v, 91, 96)),
+                                     inRange16(v, 123, 126)));
+}
+
+// ' ', '\t' and 11-13: exactly CC_BLANK
+__attribute__((target("sse2")))
+static inline __m128i blanks16(__m128i v) {
+    return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                        inRange16(v, 11, 13));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i inRange32(__m256i v, char lo, char hi) {
+    __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8((char)(hi - lo))), offset);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i delimiters32(__m256i v) {
+    return _mm256_or_si256(_mm256_or_si256(inRange32(v, 9, 13), inRange32(v, 32, 47)),
+                           _mm256_or_si256(_mm256_or_si256(inRange32(v, 58, 64), inRange32(v, 91, 96)),
+                                           inRange32(v, 123, 126)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i blanks32(__m256i v) {
+    return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                           _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                           inRange32(v, 11, 13));
+}
+
+__attribute__((target("sse2")))
+static const char* findDelimiterSSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = (unsigned)_mm_movemask_epi8(delimiters16(v));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return findDelimiterScalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static const char* skipBlanksSSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(blanks16(v)) & 0xFFFFu;
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return skipBlanksScalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* findDelimiterAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(delimiters32(v));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return findDelimiterSSE2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* skipBlanksAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(blanks32(v));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return skipBlanksSSE2(p, end);
+}
+#endif
+
+// Kernels picked for this CPU by initCharClasses()
+static const char* (*findDelimiter)(const char* p, const char* end) = findDelimiterScalar;
+static const char* (*skipBlanks)(const char* p, const char* end) = skipBlanksScalar;
+static bool char_class_ready = false;
+
+static inline void initCharClasses(void) {
+    if (char_class_ready) {
+        return;
+    }
+    for (int c = 0; c < 256; c++) {
+        uint8_t classes = 0;
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            classes |= c == '\n' ? CC_SPACE : CC_SPACE | CC_BLANK;
+        } else if (c >= '0' && c <= '9') {
+            classes |= CC_DIGIT;
+        } else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            classes |= CC_ALPHA;
+        } else if (c > ' ' && c < 127) {
+            classes |= CC_PUNCT;
+        }
+        char_class[c] = classes;
+    }
+#ifdef CHARCLASS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        findDelimiter = findDelimiterAVX2;
+        skipBlanks = skipBlanksAVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        findDelimiter = findDelimiterSSE2;
+        skipBlanks = skipBlanksSSE2;
+    }
+#endif
+    char_class_ready = true;
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+#define INTERN_MIN_SLOTS 1024
+
+// One distinct name. The hash is kept so the table can grow and compare
+// entries without touching the text again.
+typedef struct InternName {
+    const char* text;         // NUL-terminated copy in the table's arena
+    uint32_t length;
+    uint32_t hash;
+} InternName;
+
+// Maps each distinct name to a dense id, 1 for the first name seen, 2 for
+// the next and so on; 0 is never used. Open addressing with linear probing,
+// kept at most half full.
+typedef struct InternTable {
+    Arena strings;
+    uint32_t* slots;          // id of the name in each slot, 0 if empty
+    size_t slot_count;        // a power of two
+    InternName* names;        // names[id - 1]
+    uint32_t count;
+    uint32_t capacity;
+    bool failed;              // out of memory: names not yet seen get id 0 until the next reset
+} InternTable;
+
+// FNV-1a
+static inline uint32_t hashName(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Returns false when out of memory. The table can still be used and freed;
+// it stays failed and gives every name id 0.
+static inline bool initInternTable(InternTable* table) {
+    initArena(&table->strings);
+    table->slots = (uint32_t*)calloc(INTERN_MIN_SLOTS, sizeof(uint32_t));
+    table->slot_count = table->slots != NULL ? INTERN_MIN_SLOTS : 0;
+    table->names = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->failed = table->slots == NULL;
+    return table->slots != NULL;
+}
+
+static inline bool growInternSlots(InternTable* table) {
+    size_t slot_count = table->slot_count * 2;
+    uint32_t* slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+    if (slots == NULL) {
+        return false;
+    }
+    for (uint32_t id = 1; id <= table->count; id++) {
+        size_t slot = table->names[id - 1].hash & (slot_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = id;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+// Id of text[0..length), adding it if it is new. Returns 0 for a new name
+// once the table has run out of memory, and sets failed.
+static inline uint32_t internName(InternTable* table, const char* text, size_t length) {
+    uint32_t hash = hashName(text, length);
+    size_t slot = hash & (table->slot_count - 1);
+
+    if (table->slot_count == 0) {
+        return 0;
+    }
+    while (table->slots[slot] != 0) {
+        const InternName* name = &table->names[table->slots[slot] - 1];
+        if (name->hash == hash && name->length == length && memcmp(name->text, text, length) == 0) {
+            return table->slots[slot];
+        }
+        slot = (slot + 1) & (table->slot_count - 1);
+    }
+
+    // Past a failure the slots may be over half full, so nothing is added
+    if (table->failed) {
+        return 0;
+    }
+    if (table->count == table->capacity) {
+        uint32_t capacity = table->capacity ? table->capacity * 2 : 256;
+        InternName* grown = (InternName*)realloc(table->names, capacity * sizeof(InternName));
+        if (grown == NULL) {
+            table->failed = true;
+            return 0;
+        }
+        table->names = grown;
+        table->capacity = capacity;
+    }
+    char* copy = (char*)arenaAlloc(&table->strings, length + 1);
+    if (copy == NULL) {
+        table->failed = true;
+        return 0;
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    table->names[table->count].text = copy;
+    table->names[table->count].length = (uint32_t)length;
+    table->names[table->count].hash = hash;
+    table->slots[slot] = ++table->count;
+
+    if ((size_t)table->count * 2 > table->slot_count && !growInternSlots(table)) {
+        table->failed = true;
+    }
+    return table->count;
+}
+
+static inline const InternName* internedName(const InternTable* table, uint32_t id) {
+    return &table->names[id - 1];
+}
+
+// Forget every name, keeping the memory for the next file
+static inline void resetInternTable(InternTable* table) {
+    if (table->slots != NULL) {
+        memset(table->slots, 0, table->slot_count * sizeof(uint32_t));
+    }
+    arenaReset(&table->strings);
+    table->count = 0;
+    table->failed = table->slots == NULL;
+}
+
+static inline void freeInternTable(InternTable* table) {
+    freeArena(&table->strings);
+    free(table->slots);
+    free(table->names);
+    table->slots = NULL;
+    table->names = NULL;
+    table->slot_count = 0;
+    table->count = 0;
+    table->capacity = 0;
+}
+
+#endif
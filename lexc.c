@@ -0,0 +1,599 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <glob.h>
+#include <pthread.h>
+#endif
+
+#include "arena.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Combined driver: lexes and parses each file in one process. Build with
+//   gcc -O2 -pthread -DLEXC_DRIVER -o lexc lexc.c RevisedFinal.c syntax_analyzer2.c
+// Usage: lexc [--dump] [--stats] [-j threads] [--max-depth n] [path ...]
+//   (default: SourceCode.lxc)
+// A path may be a file, a directory (searched recursively for .lxc files)
+// or a quoted glob pattern. "-" lexes standard input a chunk at a time, so
+// pipes work and the input never has to fit in memory.
+// --dump also writes <file>.SymbolTable.txt and <file>.SymbolTable.bin.
+// --stats reports the arena high-water marks and the time taken when done.
+// The arena holds token lists, the recovery index and error records only:
+// the streaming lexer's window, the line index and the identifier names
+// are not counted.
+// --max-depth sets how many blocks, statements and parentheses may be open
+// at once (default PARSE_MAX_DEPTH); code nested deeper is reported and
+// skipped.
+//
+// A single file is parsed with the parser pulling tokens straight from the
+// lexer, and its summary is echoed to the console. A single file of
+// PARALLEL_LEX_MIN_SIZE or more is instead lexed into a token list on
+// -j threads (default: one per core) and its large blocks are parsed in
+// pieces on as many threads, with the same report. Several files are shared
+// out to a pool of worker threads that steal from each other when they run
+// dry. Each worker lexes and parses with its own Lexer and Parser, and the
+// reports are merged into ParseOutput.txt in the order the files were
+// named, whichever order they finished in.
+
+typedef struct FileList {
+    char** paths;
+    size_t count;
+    size_t capacity;
+} FileList;
+
+// Outcome of one file; the report lives in its worker's arena
+typedef struct FileResult {
+    char* report;
+    size_t length;
+    int errors;
+} FileResult;
+
+static bool pullFromLexer(void* context, Token* token) {
+    return nextToken((Lexer*)context, token);
+}
+
+static size_t readChunk(void* context, char* buffer, size_t size) {
+    return fread(buffer, 1, size, (FILE*)context);
+}
+
+// Returns false when out of memory
+static bool dumpSymbolTables(const char* filename, const TokenBuffer* tokens, const TriviaBuffer* trivia,
+                             const SourceBuffer* source) {
+    size_t size = strlen(filename) + sizeof(".SymbolTable.txt");
+    char* dump_name = (char*)malloc(size);
+    if (dump_name == NULL) {
+        return false;
+    }
+
+    snprintf(dump_name, size, "%s.SymbolTable.txt", filename);
+    writeSymbolTableToFile(tokens, trivia, source, dump_name, SYMBOL_TABLE_TEXT);
+    snprintf(dump_name, size, "%s.SymbolTable.bin", filename);
+    writeSymbolTableToFile(tokens, trivia, source, dump_name, SYMBOL_TABLE_BINARY);
+
+    free(dump_name);
+    return true;
+}
+
+// A path that does not fit in memory is left out of the list with a message
+static void addPath(FileList* files, const char* path) {
+    if (files->count == files->capacity) {
+        size_t capacity = files->capacity ? files->capacity * 2 : 64;
+        char** grown = (char**)realloc(files->paths, capacity * sizeof(char*));
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Not enough memory to check %s\n", path);
+            return;
+        }
+        files->paths = grown;
+        files->capacity = capacity;
+    }
+
+    char* copy = (char*)malloc(strlen(path) + 1);
+    if (copy == NULL) {
+        fprintf(stderr, "Error: Not enough memory to check %s\n", path);
+        return;
+    }
+    strcpy(copy, path);
+    files->paths[files->count++] = copy;
+}
+
+static void freeFileList(FileList* files) {
+    for (size_t i = 0; i < files->count; i++) {
+        free(files->paths[i]);
+    }
+    free(files->paths);
+}
+
+// Wall-clock milliseconds, for --stats
+static double now(void) {
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1e6;
+}
+
+static bool isDirectory(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+#ifndef _WIN32
+static bool hasLxcExtension(const char* name) {
+    size_t length = strlen(name);
+    return length >= 4 && strcmp(name + length - 4, ".lxc") == 0;
+}
+
+// Adds every .lxc file under dir, in name order, so runs are repeatable
+static void collectDirectory(FileList* files, const char* dir) {
+    struct dirent** entries;
+    int count = scandir(dir, &entries, NULL, alphasort);
+    if (count < 0) {
+        fprintf(stderr, "Error: Cannot read directory %s\n", dir);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const char* name = entries[i]->d_name;
+        if (name[0] != '.') {
+            size_t size = strlen(dir) + strlen(name) + 2;
+            char* path = (char*)malloc(size);
+            if (path == NULL) {
+                fprintf(stderr, "Error: Not enough memory to check %s/%s\n", dir, name);
+            } else {
+                snprintf(path, size, "%s/%s", dir, name);
+                if (isDirectory(path)) {
+                    collectDirectory(files, path);
+                } else if (hasLxcExtension(name)) {
+                    addPath(files, path);
+                }
+                free(path);
+            }
+        }
+        free(entries[i]);
+    }
+    free(entries);
+}
+#endif
+
+// Expands one command-line path into the files it names
+static void collectArgument(FileList* files, const char* arg) {
+#ifndef _WIN32
+    if (strcmp(arg, "-") != 0 && strpbrk(arg, "*?[") != NULL) {
+        glob_t matches;
+        if (glob(arg, 0, NULL, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                collectArgument(files, matches.gl_pathv[i]);
+            }
+        } else {
+            fprintf(stderr, "Error: No files match %s\n", arg);
+        }
+        globfree(&matches);
+        return;
+    }
+    if (isDirectory(arg)) {
+        collectDirectory(files, arg);
+        return;
+    }
+#else
+    if (isDirectory(arg)) {
+        fprintf(stderr, "Error: %s is a directory\n", arg);
+        return;
+    }
+#endif
+    addPath(files, arg);
+}
+
+// Writes why a file was not checked into its report, and to the console when
+// the file is checked on its own, and counts it as one error so that the rest
+// of a batch goes on
+static int reportUnchecked(FILE* output, FILE* echo, const char* problem) {
+    fprintf(output, "Error: %s\n", problem);
+    if (echo != NULL) {
+        fprintf(stderr, "Error: %s\n", problem);
+    }
+    return 1;
+}
+
+// One more error if the file's arena, names or lines ran out of memory,
+// since part of the file then went unchecked
+static int checkedWhole(const Arena* scratch, const InternTable* names, const LineIndex* lines,
+                        FILE* output, FILE* echo) {
+    if (!scratch->failed && !names->failed && !lines->failed) {
+        return 0;
+    }
+    return reportUnchecked(output, echo, "Not enough memory to check the whole file.");
+}
+
+// Lexes and parses one file, pulling tokens straight from the lexer unless
+// --dump or a parse on more than one thread needs them in a token list
+// first. Anything kept for the file alone, including the parser's error
+// records, goes in scratch, and identifiers are numbered in names. Both are
+// reset here, so their memory is reused from file to file. If either runs
+// out of memory the check is cut short, and that is one more error.
+static int checkFile(Parser* parser, const char* filename, Arena* scratch, InternTable* names,
+                     bool dump, int threads, FILE* output, FILE* echo) {
+    SourceBuffer source = {0};
+    TokenBuffer tokens;
+    TriviaBuffer trivia;
+    LineIndex lines;
+    Lexer lexer;
+    const char* problem;
+    int errors = 0;
+
+    arenaReset(scratch);
+    resetInternTable(names);
+
+    if (strcmp(filename, "-") == 0) {
+        if (dump) {
+            return reportUnchecked(output, echo, "--dump needs a file, not standard input.");
+        }
+        initTriviaTally(&trivia);
+        initLineIndex(&lines);
+        initChunkedLexer(&lexer, readChunk, stdin);
+        lexer.names = names;
+        lexer.trivia = &trivia;
+        lexer.lines = &lines;
+        setTokenSource(parser, pullFromLexer, &lexer, &lexer.text, &trivia, &lines);
+        errors = syntaxAnalyzer(parser, output, echo);
+        freeLexer(&lexer);
+        freeLineIndex(&lines);
+        return errors + checkedWhole(scratch, names, &lines, output, echo);
+    }
+
+    problem = openSourceFile(filename, &source);
+    if (problem != NULL) {
+        return reportUnchecked(output, echo, problem);
+    }
+    if (source.size < PARALLEL_LEX_MIN_SIZE) {
+        threads = 1;
+    }
+    if (dump || threads > 1) {
+        initArenaTokenBuffer(&tokens, scratch);
+        initArenaTriviaBuffer(&trivia, scratch);
+        lexicalAnalyzerParallel(&source, &tokens, &trivia, names, threads);
+        if (dump && !dumpSymbolTables(filename, &tokens, &trivia, &source)) {
+            errors += reportUnchecked(output, echo, "Not enough memory to write the symbol tables.");
+        }
+        buildLineIndex(&source, &lines);
+        loadTokens(parser, tokens.tokens, tokens.count, trivia.trivia, trivia.count,
+                   source.data, source.size, lines.starts, lines.count);
+    } else {
+        initTriviaTally(&trivia);
+        initLineIndex(&lines);
+        initLexer(&lexer, &source);
+        lexer.names = names;
+        lexer.trivia = &trivia;
+        lexer.lines = &lines;
+        setTokenSource(parser, pullFromLexer, &lexer, &lexer.text, &trivia, &lines);
+    }
+    errors += syntaxAnalyzerParallel(parser, output, echo, threads);
+    freeLineIndex(&lines);
+    releaseSourceFile(&source);
+    return errors + checkedWhole(scratch, names, &lines, output, echo);
+}
+
+// A report is written to memory first, then copied into the worker's arena.
+// Returns NULL if no report can be made.
+static FILE* openReport(char** report, size_t* length) {
+#ifndef _WIN32
+    return open_memstream(report, length);
+#else
+    (void)report;
+    (void)length;
+    return tmpfile();
+#endif
+}
+
+// The report of a file whose own report could not be made or kept
+static void reportLost(FileResult* result) {
+    static char lost[] = "Error: Not enough memory for the report of this file.\n";
+    result->report = lost;
+    result->length = sizeof(lost) - 1;
+    result->errors++;
+}
+
+static void closeReport(FILE* output, char** report, size_t* length, Arena* arena, FileResult* result) {
+#ifndef _WIN32
+    fclose(output);             // fills in *report and *length
+#else
+    *length = (size_t)ftell(output);
+    *report = (char*)malloc(*length + 1);
+    if (*report != NULL) {
+        rewind(output);
+        *length = fread(*report, 1, *length, output);
+    }
+    fclose(output);
+#endif
+    result->report = *report != NULL ? (char*)arenaAlloc(arena, *length) : NULL;
+    if (result->report == NULL) {
+        reportLost(result);
+    } else {
+        result->length = *length;
+        memcpy(result->report, *report, *length);
+    }
+    free(*report);
+}
+
+#ifndef _WIN32
+// Files a worker still has to check: [head, tail) of the file list. The
+// owner takes from the tail and thieves from the head, so they rarely meet.
+typedef struct WorkQueue {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+} WorkQueue;
+
+typedef struct Batch Batch;
+
+typedef struct Worker {
+    Batch* batch;
+    int id;
+    pthread_t thread;
+    WorkQueue queue;
+    Arena scratch;            // per-file tokens and errors, reset for each file
+    InternTable names;        // per-file identifier ids
+    Parser parser;
+} Worker;
+
+struct Batch {
+    const FileList* files;
+    FileResult* results;
+    Arena* arenas;            // one per worker, outlives the pool
+    Worker* workers;
+    int worker_count;
+    bool dump;
+};
+
+static bool takeWork(Worker* worker, size_t* index) {
+    Batch* batch = worker->batch;
+
+    pthread_mutex_lock(&worker->queue.lock);
+    if (worker->queue.head < worker->queue.tail) {
+        *index = --worker->queue.tail;
+        pthread_mutex_unlock(&worker->queue.lock);
+        return true;
+    }
+    pthread_mutex_unlock(&worker->queue.lock);
+
+    // Own queue is empty: steal the oldest file from the next busy worker
+    for (int n = 1; n < batch->worker_count; n++) {
+        WorkQueue* victim = &batch->workers[(worker->id + n) % batch->worker_count].queue;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->head < victim->tail) {
+            *index = victim->head++;
+            pthread_mutex_unlock(&victim->lock);
+            return true;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return false;
+}
+
+static void* batchWorker(void* argument) {
+    Worker* worker = (Worker*)argument;
+    Batch* batch = worker->batch;
+    size_t index;
+
+    while (takeWork(worker, &index)) {
+        const char* filename = batch->files->paths[index];
+        FileResult* result = &batch->results[index];
+        char* report = NULL;
+        size_t length = 0;
+        FILE* output = openReport(&report, &length);
+
+        if (output == NULL) {
+            reportLost(result);
+            continue;
+        }
+        result->errors = checkFile(&worker->parser, filename, &worker->scratch, &worker->names, batch->dump, 1,
+                                  output, NULL);
+        closeReport(output, &report, &length, &batch->arenas[worker->id], result);
+    }
+    return NULL;
+}
+
+// Checks every file on a pool of threads; results[i] belongs to paths[i].
+// Returns the most scratch memory any one file needed.
+static size_t runBatch(const FileList* files, FileResult* results, Arena* arenas, int threads, bool dump,
+                       size_t max_depth) {
+    size_t peak = 0;
+    Batch batch;
+    Worker* workers = (Worker*)calloc((size_t)threads, sizeof(Worker));
+    if (workers == NULL) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+
+    batch.files = files;
+    batch.results = results;
+    batch.arenas = arenas;
+    batch.workers = workers;
+    batch.worker_count = threads;
+    batch.dump = dump;
+
+    initLexerTables();
+
+    // Each worker starts with an equal run of the list
+    for (int i = 0; i < threads; i++) {
+        workers[i].batch = &batch;
+        workers[i].id = i;
+        workers[i].queue.head = files->count * (size_t)i / (size_t)threads;
+        workers[i].queue.tail = files->count * (size_t)(i + 1) / (size_t)threads;
+        pthread_mutex_init(&workers[i].queue.lock, NULL);
+        initArena(&workers[i].scratch);
+        initParser(&workers[i].parser, &workers[i].scratch);
+        workers[i].parser.max_depth = max_depth;
+        initInternTable(&workers[i].names);
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i].thread, NULL, batchWorker, &workers[i]) != 0) {
+            fprintf(stderr, "Error: Cannot start worker thread\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    // Only now, since a worker may steal from any queue until it finishes
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&workers[i].queue.lock);
+        if (workers[i].scratch.high_water > peak) {
+            peak = workers[i].scratch.high_water;
+        }
+        freeArena(&workers[i].scratch);
+        freeInternTable(&workers[i].names);
+    }
+
+    free(workers);
+    return peak;
+}
+#else
+static size_t runBatch(const FileList* files, FileResult* results, Arena* arenas, int threads, bool dump,
+                       size_t max_depth) {
+    Parser parser;
+    Arena scratch;
+    InternTable names;
+    size_t peak;
+
+    (void)threads;
+    initArena(&scratch);
+    initParser(&parser, &scratch);
+    parser.max_depth = max_depth;
+    initInternTable(&names);
+    for (size_t i = 0; i < files->count; i++) {
+        char* report = NULL;
+        size_t length = 0;
+        FILE* output = openReport(&report, &length);
+        if (output == NULL) {
+            reportLost(&results[i]);
+            continue;
+        }
+        results[i].errors = checkFile(&parser, files->paths[i], &scratch, &names, dump, 1, output, NULL);
+        closeReport(output, &report, &length, &arenas[0], &results[i]);
+    }
+    peak = scratch.high_water;
+    freeArena(&scratch);
+    freeInternTable(&names);
+    return peak;
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    bool dump = false;
+    bool stats = false;
+    int threads = 0;
+    size_t max_depth = PARSE_MAX_DEPTH;
+    int files_with_errors = 0;
+    FileList files = {0};
+    double started;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dump") == 0) {
+            dump = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc) {
+            int depth = atoi(argv[++i]);
+            if (depth > 0) {
+                max_depth = (size_t)depth;
+            }
+        } else {
+            collectArgument(&files, argv[i]);
+        }
+    }
+    if (argc == 1) {
+        addPath(&files, "SourceCode.lxc");
+    }
+    if (files.count == 0) {
+        fprintf(stderr, "Error: No source files to check\n");
+        return 1;
+    }
+
+    FILE* output = fopen("ParseOutput.txt", "w");
+    if (output == NULL) {
+        fprintf(stderr, "Error: Cannot create ParseOutput.txt\n");
+        return 1;
+    }
+    started = now();
+
+    if (files.count == 1) {
+        Parser parser;
+        Arena scratch;
+        InternTable names;
+        initArena(&scratch);
+        initParser(&parser, &scratch);
+        parser.max_depth = max_depth;
+        initInternTable(&names);
+
+        fprintf(output, "=== %s ===\n", files.paths[0]);
+        printf("=== %s ===\n", files.paths[0]);
+        if (checkFile(&parser, files.paths[0], &scratch, &names, dump, threads > 0 ? threads : lexerThreadCount(),
+                      output, stdout) > 0) {
+            files_with_errors++;
+        }
+        fprintf(output, "\n");
+
+        if (stats) {
+            printf("\nMemory: %zu bytes of arena data (token lists and error records)\n", scratch.high_water);
+            printf("Time: %.1f ms\n", now() - started);
+        }
+        freeArena(&scratch);
+        freeInternTable(&names);
+    } else {
+        if (threads <= 0) {
+            threads = lexerThreadCount();
+        }
+        if ((size_t)threads > files.count) {
+            threads = (int)files.count;
+        }
+
+        FileResult* results = (FileResult*)calloc(files.count, sizeof(FileResult));
+        Arena* arenas = (Arena*)calloc((size_t)threads, sizeof(Arena));
+        if (results == NULL || arenas == NULL) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        for (int i = 0; i < threads; i++) {
+            initArena(&arenas[i]);
+        }
+
+        size_t peak = runBatch(&files, results, arenas, threads, dump, max_depth);
+
+        // Merge in command-line order so the output never depends on timing
+        for (size_t i = 0; i < files.count; i++) {
+            fprintf(output, "=== %s ===\n", files.paths[i]);
+            fwrite(results[i].report, 1, results[i].length, output);
+            fprintf(output, "\n");
+            printf("%s: %d error(s)\n", files.paths[i], results[i].errors);
+            if (results[i].errors > 0) {
+                files_with_errors++;
+            }
+        }
+        printf("\n%zu file(s) checked, %d with errors\n", files.count, files_with_errors);
+        if (stats) {
+            size_t reports = 0;
+            for (int i = 0; i < threads; i++) {
+                reports += arenas[i].used;
+            }
+            printf("Memory: at most %zu bytes of arena data per file, %zu bytes of reports\n", peak, reports);
+            printf("Time: %.1f ms\n", now() - started);
+        }
+
+        for (int i = 0; i < threads; i++) {
+            freeArena(&arenas[i]);
+        }
+        free(arenas);
+        free(results);
+    }
+
+    fclose(output);
+    freeFileList(&files);
+    printf("\nResults saved to 'ParseOutput.txt'\n");
+
+    return files_with_errors > 0 ? 1 : 0;
+}
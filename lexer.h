@@ -0,0 +1,160 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "intern.h"
+#include "source.h"
+#include "tokens.h"
+
+#define MAX_LEXEME_LEN 50
+
+// Chunked input is read LEXER_CHUNK_SIZE bytes at a time. A token is only
+// started with LEXER_LOOKAHEAD bytes buffered past it (or at end of input),
+// which covers the most the lexer has to see at once: the kept part of a
+// word and the byte after it. Longer words and comments are scanned on
+// across chunks.
+#define LEXER_CHUNK_SIZE (1 << 16)
+#define LEXER_LOOKAHEAD (MAX_LEXEME_LEN + 1)
+
+// Sources at least this big are lexed on several threads
+#define PARALLEL_LEX_MIN_SIZE (4 << 20)
+
+// Growable array of tokens with amortised O(1) append
+typedef struct TokenBuffer {
+    Token* tokens;
+    size_t count;
+    size_t capacity;
+    Arena* arena;             // owns tokens if set, else they are malloc'd
+} TokenBuffer;
+
+// Whitespace and comments found beside the tokens, in input order. A
+// tally-only buffer keeps no entries, just how much trivia was found since
+// the tally was last cleared, for a reader that keeps pace with the lexer.
+typedef struct TriviaBuffer {
+    Trivia* trivia;
+    size_t count;
+    size_t capacity;
+    Arena* arena;             // owns trivia if set, else it is malloc'd
+    bool tally_only;
+    uint64_t whitespace;      // tally: whitespace bytes and comments found
+    uint64_t comments;
+} TriviaBuffer;
+
+// Byte offset where each line starts: starts[i] is where line first_line + i
+// begins. Line and column are looked up here only when a message needs them.
+typedef struct LineIndex {
+    uint64_t* starts;
+    size_t count;
+    size_t capacity;
+    uint64_t first_line;      // 1 unless a chunked lexer forgot the lines behind its window
+    uint64_t cut_line;        // start of the line a chunked lexer's window begins inside
+    uint64_t cut_tabs;        // tabs of that line that have scrolled out of the window
+    bool failed;              // out of memory: the lines after count are missing
+} LineIndex;
+
+// Index in lines->starts of the line holding offset, or lines->count if that
+// line is not in the table
+static inline size_t findLine(const LineIndex* lines, uint64_t offset) {
+    size_t low = 0, high = lines->count;
+    if (lines->count == 0 || offset < lines->starts[0]) {
+        return lines->count;
+    }
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (lines->starts[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Column of offset on line lines->starts[line]: one per byte and four per
+// tab. Tabs of the line that are no longer in text were counted on the way out.
+static inline uint64_t findColumn(const SourceText* text, const LineIndex* lines, size_t line, uint64_t offset) {
+    uint64_t line_start = lines->starts[line];
+    uint64_t column = 1 + (offset - line_start);
+    if (line_start < text->offset && line_start == lines->cut_line) {
+        column += 3 * lines->cut_tabs;
+    }
+    uint64_t from = line_start > text->offset ? line_start : text->offset;
+    uint64_t to = offset < text->offset + text->size ? offset : text->offset + text->size;
+    const char* p = text->data + (from - text->offset);
+    const char* end = text->data + (to - text->offset);
+    while (p < end && (p = (const char*)memchr(p, '\t', end - p)) != NULL) {
+        column += 3;
+        p++;
+    }
+    return column;
+}
+
+// Reads up to size bytes of input into buffer; returns 0 at end of input
+typedef size_t (*ReadChunkFn)(void* context, char* buffer, size_t size);
+
+// Scan state for pulling tokens one at a time with nextToken()
+typedef struct Lexer {
+    SourceText text;          // input currently buffered; token starts are input offsets
+    const char* p;            // next byte to scan, inside text
+    ReadChunkFn read;         // NULL when the whole input is in text
+    void* read_context;
+    char* buffer;             // window for chunked input
+    size_t buffer_capacity;
+    bool at_eof;
+    bool in_word;             // skipping the rest of a word longer than the window
+    char span;                // '#' or '*' inside a ## or #* comment, '"' inside a string, else 0
+    uint64_t span_start;      // input offset of that comment or string
+    InternTable* names;       // identifiers are interned here if set
+    LineIndex* lines;         // line starts are recorded here if set
+    TriviaBuffer* trivia;     // whitespace and comments are recorded here if set
+    bool trivia_run;          // the last trivia is whitespace the next byte may extend
+    bool trivia_tokens;       // return whitespace and comments as tokens instead
+    uint64_t stop;            // no token is started at or past this input offset
+    uint64_t line_start;      // input offset of the current line
+    uint64_t retain;          // input offset the window must keep: the last token's line
+    uint64_t queue_line_start;
+    int queue_head;           // tokens found but not yet returned
+    int queue_count;
+    Token queue[MAX_LEXEME_LEN];
+} Lexer;
+
+typedef enum SymbolTableFormat {
+    SYMBOL_TABLE_TEXT,      // one "TYPE lexeme" line per token
+    SYMBOL_TABLE_BINARY     // token stream, see TokenStreamHeader in tokens.h
+} SymbolTableFormat;
+
+const char* openSourceFile(const char *filename, SourceBuffer* source);
+void initLexer(Lexer* lexer, const SourceBuffer* source);
+void initLexerRange(Lexer* lexer, const SourceBuffer* source, uint64_t start, uint64_t stop);
+void initChunkedLexer(Lexer* lexer, ReadChunkFn read, void* context);
+void freeLexer(Lexer* lexer);
+bool nextToken(Lexer* lexer, Token* token);
+void lexicalAnalyzer(const SourceBuffer* source, TokenBuffer* tokens, TriviaBuffer* trivia, InternTable* names);
+void lexicalAnalyzerParallel(const SourceBuffer* source, TokenBuffer* tokens, TriviaBuffer* trivia,
+                             InternTable* names, int threads);
+int lexerThreadCount(void);
+void initLexerTables(void);
+void initTokenBuffer(TokenBuffer* tokens);
+void initArenaTokenBuffer(TokenBuffer* tokens, Arena* arena);
+bool growTokenBuffer(TokenBuffer* tokens, size_t capacity);
+Token* reserveToken(TokenBuffer* tokens);
+void freeTokenBuffer(TokenBuffer* tokens);
+void initTriviaBuffer(TriviaBuffer* trivia);
+void initArenaTriviaBuffer(TriviaBuffer* trivia, Arena* arena);
+void initTriviaTally(TriviaBuffer* trivia);
+bool growTriviaBuffer(TriviaBuffer* trivia, size_t capacity);
+void appendTrivia(TriviaBuffer* trivia, TokenKind kind, uint64_t start, size_t length, bool extend);
+void freeTriviaBuffer(TriviaBuffer* trivia);
+void displayTokens(const TokenBuffer* tokens, const SourceBuffer* source);
+void initLineIndex(LineIndex* lines);
+void appendLineStart(LineIndex* lines, uint64_t offset);
+void buildLineIndex(const SourceBuffer* source, LineIndex* lines);
+void freeLineIndex(LineIndex* lines);
+void writeSymbolTableToFile(const TokenBuffer* tokens, const TriviaBuffer* trivia, const SourceBuffer* source,
+                            const char* filename, SymbolTableFormat format);
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "lexer.h"
+#include "tokens.h"
+
+#define MAX_TOKEN_LEN 1000
+#define MAX_ERRORS 100
+#define NOT_BUFFERED "(not buffered)"   // error text that scrolled out of a chunked lexer's window
+#define TOKEN_RING_SIZE 16   // tokens kept addressable: the current one and those just before it
+#ifndef PARALLEL_PARSE_CHUNK
+#define PARALLEL_PARSE_CHUNK (1 << 14)   // tokens per piece of a large block parsed on its own
+#endif
+#ifndef PARSE_MAX_DEPTH
+#define PARSE_MAX_DEPTH 10000   // default Parser.max_depth
+#endif
+
+// Token source for the parser: stores the next token and returns true, or
+// returns false at end of input
+typedef bool (*NextTokenFn)(void* context, Token* token);
+
+// Error storage structure; the texts are copied into the parser's arena
+typedef struct ErrorInfo {
+    const char* message;
+    long long line;
+    long long column;
+    const char* found;         // at most MAX_TOKEN_LEN - 1 bytes of the token, or NOT_BUFFERED
+    const char* code;          // the offending source line, marked with NOT_BUFFERED where it is cut
+} ErrorInfo;
+
+// Tokens in an array, served through the NextTokenFn interface
+typedef struct TokenArray {
+    const Token* tokens;
+    size_t count;
+    size_t next;
+} TokenArray;
+
+// Where panic-mode recovery lands in a loaded token array, one bit per token
+// so that it is found by walking bits rather than tokens.
+// The parser builds it from the array the first time recovery needs it,
+// rather than the lexer emitting it: most files are parsed straight from the
+// lexer with no array to index, and a file without errors never needs one.
+// It covers ';' and braces only, the tokens skipToSemicolon and
+// skipToCloseBrace land on. No recovery skips to a ')' or ']', so there is
+// no table for them: skipExpression stops at the first ';', brace or
+// top-level ',' and only counts parentheses on the way.
+// Tokens pulled straight from the lexer have no index, and recovery there
+// still steps one advance() at a time. Each step takes the next token the
+// lexer has to produce anyway, so that recovery is linear in the tokens it
+// skips, but it cannot jump.
+typedef struct RecoveryIndex {
+    uint64_t* stops;          // bit i % 64 of word i / 64: token i is ';' or '}'
+    uint64_t* braces;         // bit set: the token is '{' or '}'
+    uint32_t* brace_rank;     // braces before each word of braces
+    uint32_t* brace_token;    // token index of each brace, in order
+    uint32_t* brace_close;    // per brace: the first '}' at or after it not opened at or after it
+    size_t words;
+    uint32_t brace_count;
+    uint32_t end;             // no token at or past this is pulled
+} RecoveryIndex;
+
+// What is left to do for one construct that has a statement, block or
+// expression nested in it; state is one of the PS_* of syntax_analyzer2.c
+typedef struct ParseFrame {
+    int state;
+    int power;                // expression frames: the binding power outside them
+    size_t before;            // current_index when its latest statement began
+} ParseFrame;
+
+// The parser's own stack of open constructs, so that nesting takes heap
+// rather than C stack
+typedef struct ParseStack {
+    ParseFrame* frames;
+    size_t depth;
+    size_t capacity;
+    size_t peak;              // the most frames held at once, or max_depth + 1 if it was passed
+} ParseStack;
+
+// Pieces of large blocks being parsed ahead on other threads (syntax_analyzer2.c)
+typedef struct ParsePlan ParsePlan;
+
+// Everything one parse needs. Tokens are pulled from token_source on
+// demand, so only the ring is held no matter how long the input is.
+// Separate Parsers share nothing and may run on different threads.
+typedef struct Parser {
+    NextTokenFn token_source;
+    void* token_source_context;
+    Token token_ring[TOKEN_RING_SIZE];
+    Token* current_token;      // &token_ring[current_index % TOKEN_RING_SIZE], or NULL at end of input
+    size_t current_index;      // significant tokens pulled so far
+    const SourceText* source_text;  // input that token spans point into
+    const LineIndex* lines;    // line starts, for the line and column of errors; or NULL
+    TriviaBuffer* trivia;      // whitespace and comments beside the tokens, or NULL
+    size_t trivia_next;        // first entry not yet counted
+    SourceText whole_text;     // source_text for loadTokens()
+    TokenArray token_array;    // token_source_context for loadTokens()
+    TriviaBuffer whole_trivia; // trivia for loadTokens()
+    LineIndex whole_lines;     // lines for loadTokens()
+    bool tokens_counted;       // the statistics were taken for the whole input at once
+    RecoveryIndex recovery;    // for loadTokens(), built on the first recovery
+    ParsePlan* plan;           // for syntaxAnalyzerParallel(), or NULL
+    ParseStack stack;
+    size_t max_depth;          // open blocks, statements and '(' allowed at once; deeper code is skipped
+    FILE* output;
+    FILE* echo;                // console copy of the summary, or NULL
+    Arena* arena;              // error texts; never reset by the parser
+    ErrorInfo errors[MAX_ERRORS];
+    int error_count;
+    uint64_t total_tokens;
+    uint32_t name_count;       // distinct identifiers: the highest interned id seen
+    uint64_t token_counts[DELIMITER + 1];
+} Parser;
+
+void initParser(Parser* parser, Arena* arena);
+void setTokenSource(Parser* parser, NextTokenFn next, void* context, const SourceText* text,
+                    TriviaBuffer* trivia, const LineIndex* lines);
+void loadTokens(Parser* parser, const Token* tokens, size_t count, const Trivia* trivia, size_t trivia_count,
+                const char* text, size_t text_size, const uint64_t* lines, size_t lines_count);
+int syntaxAnalyzer(Parser* parser, FILE* output, FILE* echo);
+int syntaxAnalyzerParallel(Parser* parser, FILE* output, FILE* echo, int threads);
+
+#endif
@@ -0,0 +1,134 @@
+// Whole-file input shared by the lexer and the parser: the file is mmapped
+// when possible, otherwise read in one go.
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define READ_CHUNK_SIZE (1 << 16)
+
+#define SOURCE_WRITABLE 0x01   // the caller may modify the loaded bytes
+#define SOURCE_BINARY   0x02   // no newline translation on Windows
+
+typedef struct SourceBuffer {
+    const char* data;
+    size_t size;
+    bool mapped;
+} SourceBuffer;
+
+// Map the whole file; pipes and other non-regular files are read into one
+// heap buffer instead. SOURCE_WRITABLE gives a private copy-on-write view.
+// Returns false if the file cannot be read, with errno ENOMEM when it does
+// not fit in memory.
+static inline bool loadSourceFile(const char* filename, SourceBuffer* source, int flags) {
+    source->data = NULL;
+    source->size = 0;
+    source->mapped = false;
+
+#ifdef _WIN32
+    // Text mode keeps the usual newline handling for .lxc sources
+    FILE* file = fopen(filename, (flags & SOURCE_BINARY) ? "rb" : "r");
+    if (file == NULL) {
+        return false;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            close(fd);
+            return true;
+        }
+        int protection = (flags & SOURCE_WRITABLE) ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* map = mmap(NULL, (size_t)st.st_size, protection, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            close(fd);
+            source->data = (const char*)map;
+            source->size = (size_t)st.st_size;
+            source->mapped = true;
+            return true;
+        }
+    }
+#endif
+
+    // Fallback: grow one buffer until end of input
+    size_t capacity = READ_CHUNK_SIZE;
+    size_t size = 0;
+    char* buffer = (char*)malloc(capacity);
+    for (;;) {
+        if (buffer != NULL && size == capacity) {
+            capacity *= 2;
+            char* grown = (char*)realloc(buffer, capacity);
+            if (!grown) {
+                free(buffer);
+            }
+            buffer = grown;
+        }
+        if (buffer == NULL) {
+#ifdef _WIN32
+            fclose(file);
+#else
+            close(fd);
+#endif
+            errno = ENOMEM;
+            return false;
+        }
+#ifdef _WIN32
+        size_t n = fread(buffer + size, 1, capacity - size, file);
+        if (n == 0) {
+            break;
+        }
+#else
+        ssize_t n = read(fd, buffer + size, capacity - size);
+        if (n < 0) {
+            free(buffer);
+            close(fd);
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+#endif
+        size += (size_t)n;
+    }
+#ifdef _WIN32
+    fclose(file);
+#else
+    close(fd);
+#endif
+
+    source->data = buffer;
+    source->size = size;
+    return true;
+}
+
+static inline void releaseSourceFile(SourceBuffer* source) {
+#ifndef _WIN32
+    if (source->mapped) {
+        munmap((void*)source->data, source->size);
+    } else
+#endif
+    free((void*)source->data);
+    source->data = NULL;
+    source->size = 0;
+    source->mapped = false;
+}
+
+#endif
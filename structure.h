@@ -0,0 +1,241 @@
+#ifndef STRUCTURE_H
+#define STRUCTURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRUCTURE_X86 1
+#include <immintrin.h>
+#endif
+
+// Structural index of a source, built in one pass 64 bytes at a time before
+// lexing. It marks every byte that belongs to a string literal or a comment,
+// by the lexer's rules: "..." with backslash escapes, ## to the newline, #*
+// to the first *# after the '*'. The parallel lexer uses it to cut the
+// source at newlines that are code without lexing the bytes in between.
+typedef struct StructureIndex {
+    uint64_t* literal;        // bit i % 64 of word i / 64: byte i is in a string or comment, delimiters included
+    size_t words;
+    uint64_t size;
+} StructureIndex;
+
+// Positions of the characters that matter in one 64-byte block
+typedef struct StructureBlock {
+    uint64_t quote;
+    uint64_t hash;
+    uint64_t star;
+    uint64_t backslash;
+    uint64_t newline;
+} StructureBlock;
+
+enum { SCAN_CODE, SCAN_STRING, SCAN_LINE_COMMENT, SCAN_BLOCK_COMMENT };
+
+// What the scan carries from one block to the next
+typedef struct StructureScan {
+    int state;
+    bool after_hash;          // code: the last byte was a '#' that may open a comment
+    bool after_star;          // block comment: the last byte was a '*' that may close it
+    bool escaped;             // string: the last byte was a backslash escaping the next one
+} StructureScan;
+
+static inline void classifyBlockScalar(const char* p, StructureBlock* block) {
+    memset(block, 0, sizeof(*block));
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (p[i]) {
+            case '"': block->quote |= bit; break;
+            case '#': block->hash |= bit; break;
+            case '*': block->star |= bit; break;
+            case '\\': block->backslash |= bit; break;
+            case '\n': block->newline |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#ifdef STRUCTURE_X86
+__attribute__((target("sse2")))
+static inline uint64_t equalMask16(const __m128i v[4], char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    return (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[0], needle)) |
+           (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[1], needle)) << 16 |
+           (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[2], needle)) << 32 |
+           (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[3], needle)) << 48;
+}
+
+__attribute__((target("sse2")))
+static inline void classifyBlockSSE2(const char* p, StructureBlock* block) {
+    __m128i v[4];
+    for (int i = 0; i < 4; i++) {
+        v[i] = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+    }
+    block->quote = equalMask16(v, '"');
+    block->hash = equalMask16(v, '#');
+    block->star = equalMask16(v, '*');
+    block->backslash = equalMask16(v, '\\');
+    block->newline = equalMask16(v, '\n');
+}
+
+__attribute__((target("avx2")))
+static inline uint64_t equalMask32(const __m256i v[2], char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[0], needle)) |
+           (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[1], needle)) << 32;
+}
+
+__attribute__((target("avx2")))
+static inline void classifyBlockAVX2(const char* p, StructureBlock* block) {
+    __m256i v[2];
+    v[0] = _mm256_loadu_si256((const __m256i*)p);
+    v[1] = _mm256_loadu_si256((const __m256i*)(p + 32));
+    block->quote = equalMask32(v, '"');
+    block->hash = equalMask32(v, '#');
+    block->star = equalMask32(v, '*');
+    block->backslash = equalMask32(v, '\\');
+    block->newline = equalMask32(v, '\n');
+}
+#endif
+
+// Bit i of the result is the XOR of bits 0..i of x
+static inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Resolve block w: which bytes are string or comment. Blocks with no '#' or backslash, the usual case, take one
+// prefix XOR over the quotes; so do blocks wholly inside one comment or
+// string. Others are walked bit by bit.
+static inline void indexBlock(StructureIndex* index, size_t w, StructureScan* scan, const StructureBlock* block) {
+    uint64_t literal = 0;
+
+    if ((scan->state == SCAN_CODE || scan->state == SCAN_STRING) && !scan->after_hash && !scan->escaped &&
+        (block->hash | block->backslash) == 0) {
+        // Each quote opens or closes; a closing quote is part of the string
+        uint64_t inside = prefixXor(block->quote) ^ (scan->state == SCAN_STRING ? ~(uint64_t)0 : 0);
+        literal = inside | block->quote;
+        scan->state = (inside >> 63) ? SCAN_STRING : SCAN_CODE;
+    } else if (scan->state == SCAN_LINE_COMMENT && block->newline == 0) {
+        literal = ~(uint64_t)0;
+    } else if (scan->state == SCAN_BLOCK_COMMENT &&
+               (block->hash & (block->star << 1 | (scan->after_star ? 1 : 0))) == 0) {
+        literal = ~(uint64_t)0;
+        scan->after_star = (block->star >> 63) != 0;
+    } else {
+        for (int i = 0; i < 64; i++) {
+            uint64_t bit = (uint64_t)1 << i;
+            switch (scan->state) {
+                case SCAN_CODE:
+                    if (scan->after_hash) {
+                        scan->after_hash = false;
+                        if ((block->hash | block->star) & bit) {
+                            // The '#' before this byte opened a comment
+                            if (i > 0) {
+                                literal |= bit >> 1;
+                            } else {
+                                index->literal[w - 1] |= (uint64_t)1 << 63;
+                            }
+                            literal |= bit;
+                            scan->state = (block->hash & bit) ? SCAN_LINE_COMMENT : SCAN_BLOCK_COMMENT;
+                            scan->after_star = (block->star & bit) != 0;
+                            break;
+                        }
+                    }
+                    if (block->quote & bit) {
+                        literal |= bit;
+                        scan->state = SCAN_STRING;
+                    } else if (block->hash & bit) {
+                        scan->after_hash = true;
+                    }
+                    break;
+                case SCAN_STRING:
+                    literal |= bit;
+                    if (scan->escaped) {
+                        scan->escaped = false;
+                    } else if (block->backslash & bit) {
+                        scan->escaped = true;
+                    } else if (block->quote & bit) {
+                        scan->state = SCAN_CODE;
+                    }
+                    break;
+                case SCAN_LINE_COMMENT:
+                    if (block->newline & bit) {
+                        scan->state = SCAN_CODE;
+                    } else {
+                        literal |= bit;
+                    }
+                    break;
+                default:
+                    literal |= bit;
+                    if ((block->hash & bit) && scan->after_star) {
+                        scan->state = SCAN_CODE;
+                        scan->after_star = false;
+                    } else {
+                        scan->after_star = (block->star & bit) != 0;
+                    }
+                    break;
+            }
+        }
+    }
+    index->literal[w] = literal;
+}
+
+static inline void buildStructureIndex(StructureIndex* index, const char* text, uint64_t size) {
+    StructureScan scan = {SCAN_CODE, false, false, false};
+    StructureBlock block;
+    void (*classify)(const char*, StructureBlock*) = classifyBlockScalar;
+
+    index->size = size;
+    index->words = (size_t)((size + 63) / 64);
+    index->literal = (uint64_t*)malloc((index->words ? index->words : 1) * sizeof(uint64_t));
+    if (!index->literal) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+#ifdef STRUCTURE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        classify = classifyBlockAVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        classify = classifyBlockSSE2;
+    }
+#endif
+
+    size_t full = (size_t)(size / 64);
+    for (size_t w = 0; w < full; w++) {
+        classify(text + 64 * w, &block);
+        indexBlock(index, w, &scan, &block);
+    }
+    if (full < index->words) {
+        // The tail is padded with NULs, which are none of the characters above
+        char tail[64] = {0};
+        size_t rest = (size_t)(size % 64);
+        memcpy(tail, text + 64 * full, rest);
+        classifyBlockScalar(tail, &block);
+        indexBlock(index, full, &scan, &block);
+        index->literal[full] &= ((uint64_t)1 << rest) - 1;
+    }
+}
+
+static inline void freeStructureIndex(StructureIndex* index) {
+    free(index->literal);
+    index->literal = NULL;
+    index->words = 0;
+    index->size = 0;
+}
+
+// True if the byte at offset is part of a string literal or comment
+static inline bool isLiteralByte(const StructureIndex* index, uint64_t offset) {
+    return (index->literal[offset / 64] >> (offset % 64)) & 1;
+}
+
+#endif
@@ -1,980 +1,1904 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <stdbool.h>
-
-#define MAX_TOKEN_LEN 1000
-#define MAX_ERRORS 100
-
-// Token types from lexical analyzer
-typedef enum {
-    IDENTIFIER,
-    OPERATION,
-    KEYWORDS,
-    RESERVED_WORDS,
-    CONSTANT,
-    NOISE_WORDS,
-    COMMENT,
-    WHITE_SPACE,
-    DELIMITER
-} TokenType;
-
-// Token structure
-typedef struct Token {
-    TokenType type;
-    char lexeme[MAX_TOKEN_LEN];
-    int line;
-    int column;
-    struct Token* next;
-} Token;
-
-// Error storage structure
-typedef struct ErrorInfo {
-    char message[500];
-    int line;
-    int column;
-    char found[MAX_TOKEN_LEN];
-} ErrorInfo;
-
-// Global variables for parsing
-Token* current_token = NULL;
-Token* token_list = NULL;
-FILE* parse_output = NULL;
-ErrorInfo errors[MAX_ERRORS];
-int error_count = 0;
-
-// Add token counters and prototype
-int total_tokens = 0;
-int token_counts[DELIMITER + 1] = {0};
-void printTokenStatistics(void);
-
-// Function prototypes
-void readTokensFromFile(const char* filename);
-void syntaxAnalyzer();
-void advance();
-bool match(TokenType type, const char* lexeme);
-bool matchType(TokenType type);
-bool check(TokenType type, const char* lexeme);
-bool checkType(TokenType type);
-void recordError(const char* message);
-void skipWhitespace();
-void synchronize();
-void skipToSemicolon();
-void skipToCloseBrace();
-
-// Grammar rule functions
-void parseProgram();
-void parseBlock();
-void parseStatement();
-void parseDecStmt();
-void parseAssStmt();
-void parseConditionalStmt();
-void parseIterativeStmt();
-void parseOutputStmt();
-void parseInputStmt();
-void parseBreakStmt();
-void parseExpr();
-void parseLogicalOrExpr();
-void parseLogicalAndExpr();
-void parseEqualityExpr();
-void parseRelationalExpr();
-void parseAdditiveExpr();
-void parseMultiplicativeExpr();
-void parseUnaryExpr();
-void parsePostfixExpr();
-void parsePrimaryExpr();
-void parseIdList();
-void parseExprList();
-bool isDataType();
-bool isScopeModifier();
-
-int main() {
-    // Read tokens from symbol table
-    readTokensFromFile("SymbolTable.txt");
-    
-    // Open output file for parse results
-    parse_output = fopen("ParseOutput.txt", "w");
-    if (parse_output == NULL) {
-        fprintf(stderr, "Error: Cannot create ParseOutput.txt\n");
-        return 1;
-    }
-       
-    // Start syntax analysis
-    fprintf(parse_output, "=== SYNTAX ANALYSIS ===\n\n");
-    printf("Starting syntax analysis...\n");
-    printf("Using: Recursive Descent Parser with Panic Mode Recovery\n\n");
-    
-    current_token = token_list;
-    skipWhitespace();
-    
-      // Print token statistics before parsing
-    printTokenStatistics();
-    
-    parseProgram();
-    
-    // Display all errors at the end
-    fprintf(parse_output, "\n=== ANALYSIS COMPLETE ===\n\n");
-    
-    if (error_count == 0) {
-        fprintf(parse_output, "SUCCESS: Your code has no syntax errors.\n");
-        printf("\n SUCCESS: Your code has no syntax errors.\n");
-    } else {
-        fprintf(parse_output, " FOUND %d ERROR(S):\n\n", error_count);
-        printf("\n FOUND %d ERROR(S):\n\n", error_count);
-        
-        for (int i = 0; i < error_count; i++) {
-            fprintf(parse_output, "Error %d (Line %d, Column %d):\n", 
-                    i + 1, errors[i].line, errors[i].column);
-            fprintf(parse_output, "  Problem: %s\n", errors[i].message);
-            fprintf(parse_output, "  Found: '%s'\n\n", errors[i].found);
-            
-            printf("Error %d (Line %d, Column %d):\n", 
-                   i + 1, errors[i].line, errors[i].column);
-            printf("  Problem: %s\n", errors[i].message);
-            printf("  Found: '%s'\n\n", errors[i].found);
-        }
-        
-        fprintf(parse_output, "Total: %d error(s) need to be fixed\n", error_count);
-        printf("Total: %d error(s) need to be fixed\n", error_count);
-    }
-    
-    fclose(parse_output);
-    printf("\nResults saved to 'ParseOutput.txt'\n");
-    
-    return error_count > 0 ? 1 : 0;
-}
-
-void readTokensFromFile(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        fprintf(stderr, "Error: Cannot open %s\n", filename);
-        exit(1);
-    }
-    
-    char type_str[50];
-    char lexeme[MAX_TOKEN_LEN];
-    int line, column;
-    Token* tail = NULL;
-    
-    bool in_string = false;
-    char string_buffer[MAX_TOKEN_LEN] = "";
-    int string_line = 0, string_column = 0;
-    
-    while (fscanf(file, "%s", type_str) == 1) {
-        Token* tok = (Token*)malloc(sizeof(Token));
-        
-        // Parse token type
-        if (strcmp(type_str, "IDENTIFIER") == 0) tok->type = IDENTIFIER;
-        else if (strcmp(type_str, "OPERATION") == 0) tok->type = OPERATION;
-        else if (strcmp(type_str, "KEYWORDS") == 0) tok->type = KEYWORDS;
-        else if (strcmp(type_str, "RESERVED_WORDS") == 0) tok->type = RESERVED_WORDS;
-        else if (strcmp(type_str, "CONSTANT") == 0) tok->type = CONSTANT;
-        else if (strcmp(type_str, "NOISE_WORDS") == 0) tok->type = NOISE_WORDS;
-        else if (strcmp(type_str, "COMMENT") == 0) tok->type = COMMENT;
-        else if (strcmp(type_str, "WHITE_SPACE") == 0) tok->type = WHITE_SPACE;
-        else if (strcmp(type_str, "DELIMITER") == 0) tok->type = DELIMITER;
-        
-        fscanf(file, "%s", lexeme);
-        
-        if (strcmp(lexeme, "\\n") == 0) strcpy(tok->lexeme, "\n");
-        else if (strcmp(lexeme, "\\t") == 0) strcpy(tok->lexeme, "\t");
-        else if (strcmp(lexeme, "_") == 0) strcpy(tok->lexeme, " ");
-        else strcpy(tok->lexeme, lexeme);
-        
-        fscanf(file, "%d %d", &line, &column);
-        tok->line = line;
-        tok->column = column;
-        
-        // Handle string literal reconstruction
-        if (tok->type == RESERVED_WORDS && strcmp(tok->lexeme, "\"") == 0) {
-            if (!in_string) {
-                in_string = true;
-                strcpy(string_buffer, "\"");
-                string_line = line;
-                string_column = column;
-                free(tok);
-                continue;
-            } else {
-                strcat(string_buffer, "\"");
-                strcpy(tok->lexeme, string_buffer);
-                tok->line = string_line;
-                tok->column = string_column;
-                in_string = false;
-                string_buffer[0] = '\0';
-            }
-        } else if (in_string) {
-            if (tok->type == IDENTIFIER) {
-                strcat(string_buffer, tok->lexeme);
-            }
-            free(tok);
-            continue;
-        }
-        
-        tok->next = NULL;
-        
-        if (token_list == NULL) {
-            token_list = tok;
-            tail = tok;
-        } else {
-            tail->next = tok;
-            tail = tok;
-        }
-        // Increment token counters for tokens actually added to the list
-    total_tokens++;
-    if (tok->type >= 0 && tok->type <= DELIMITER) {
-        token_counts[tok->type]++;
-    }
-    }
-    
-    fclose(file);
-}
-
-void skipWhitespace() {
-    while (current_token != NULL && 
-           (current_token->type == WHITE_SPACE || current_token->type == COMMENT)) {
-        current_token = current_token->next;
-    }
-}
-
-void advance() {
-    if (current_token != NULL) {
-        current_token = current_token->next;
-        skipWhitespace();
-    }
-}
-
-bool match(TokenType type, const char* lexeme) {
-    if (check(type, lexeme)) {
-        advance();
-        return true;
-    }
-    if (type == KEYWORDS && current_token != NULL && 
-        current_token->type == IDENTIFIER && strcmp(current_token->lexeme, lexeme) == 0) {
-        advance();
-        return true;
-    }
-    return false;
-}
-
-bool matchType(TokenType type) {
-    if (checkType(type)) {
-        advance();
-        return true;
-    }
-    return false;
-}
-
-bool check(TokenType type, const char* lexeme) {
-    if (current_token == NULL) return false;
-    return current_token->type == type && strcmp(current_token->lexeme, lexeme) == 0;
-}
-
-bool checkType(TokenType type) {
-    if (current_token == NULL) return false;
-    return current_token->type == type;
-}
-
-void recordError(const char* message) {
-    if (error_count >= MAX_ERRORS) return;
-    
-    strcpy(errors[error_count].message, message);
-    if (current_token != NULL) {
-        errors[error_count].line = current_token->line;
-        errors[error_count].column = current_token->column;
-        strcpy(errors[error_count].found, current_token->lexeme);
-    } else {
-        errors[error_count].line = -1;
-        errors[error_count].column = -1;
-        strcpy(errors[error_count].found, "end of file");
-    }
-    error_count++;
-}
-
-// Panic mode recovery: skip to semicolon
-void skipToSemicolon() {
-    while (current_token != NULL && !check(DELIMITER, ";")) {
-        // Also stop at closing brace to avoid skipping too much
-        if (check(DELIMITER, "}")) {
-            return;
-        }
-        advance();
-    }
-    if (check(DELIMITER, ";")) {
-        advance(); // consume the semicolon
-    }
-}
-
-// Panic mode recovery: skip to closing brace
-void skipToCloseBrace() {
-    int brace_count = 1;
-    while (current_token != NULL && brace_count > 0) {
-        if (check(DELIMITER, "{")) {
-            brace_count++;
-        } else if (check(DELIMITER, "}")) {
-            brace_count--;
-            if (brace_count == 0) {
-                return; // Don't consume the closing brace
-            }
-        }
-        advance();
-    }
-}
-
-bool isDataType() {
-    if (current_token == NULL || current_token->type != KEYWORDS) return false;
-    return strcmp(current_token->lexeme, "int") == 0 ||
-           strcmp(current_token->lexeme, "float") == 0 ||
-           strcmp(current_token->lexeme, "char") == 0 ||
-           strcmp(current_token->lexeme, "text") == 0 ||
-           strcmp(current_token->lexeme, "bool") == 0 ||
-           strcmp(current_token->lexeme, "time") == 0 ||
-           strcmp(current_token->lexeme, "date") == 0 ||
-           strcmp(current_token->lexeme, "timestamp") == 0;
-}
-
-bool isScopeModifier() {
-    if (current_token == NULL || current_token->type != KEYWORDS) return false;
-    return strcmp(current_token->lexeme, "let") == 0 ||
-           strcmp(current_token->lexeme, "var") == 0 ||
-           strcmp(current_token->lexeme, "out") == 0 ||
-           strcmp(current_token->lexeme, "in") == 0 ||
-           strcmp(current_token->lexeme, "only") == 0;
-}
-
-void parseProgram() {
-    fprintf(parse_output, "Parsing PROGRAM...\n");
-    
-    // Check for 'func' keyword (optional)
-    if (current_token != NULL && strcmp(current_token->lexeme, "func") == 0) {
-        advance();
-    }
-    
-    // 'main' keyword - might be IDENTIFIER or KEYWORDS depending on lexer
-    if (current_token != NULL && strcmp(current_token->lexeme, "main") == 0) {
-        advance();
-    } else {
-        recordError("Missing 'main' at the start of your program");
-        // Try to recover by looking for ':'
-        while (current_token != NULL && !check(DELIMITER, ":")) {
-            advance();
-        }
-    }
-    
-    if (!match(DELIMITER, ":")) {
-        recordError("Missing ':' after 'main'");
-        // Continue anyway to find more errors
-    }
-    
-    // Check if there's a block with braces or just statements
-    if (check(DELIMITER, "{")) {
-        // Traditional block with braces
-        parseBlock();
-    } else {
-        // No braces - parse all statements until end of file
-        fprintf(parse_output, "  Parsing statements without block braces...\n");
-        while (current_token != NULL) {
-            Token* before = current_token;
-            parseStatement();
-            
-            // If we're stuck on the same token, skip it to prevent infinite loop
-            if (current_token == before && current_token != NULL) {
-                fprintf(parse_output, "  Warning: Skipping stuck token '%s'\n", current_token->lexeme);
-                advance();
-            }
-        }
-        fprintf(parse_output, "  All statements parsed.\n");
-    }
-    
-    fprintf(parse_output, "PROGRAM parsing done.\n");
-}
-
-void parseBlock() {
-    fprintf(parse_output, "  Parsing BLOCK...\n");
-    
-    if (!match(DELIMITER, "{")) {
-        recordError("Missing '{' to start a block");
-        // Try to continue parsing statements
-    }
-    
-    while (current_token != NULL && !check(DELIMITER, "}")) {
-        Token* before = current_token;
-        parseStatement();
-        
-        // If we're stuck on the same token, skip it to prevent infinite loop
-        if (current_token == before && current_token != NULL) {
-            fprintf(parse_output, "  Warning: Skipping stuck token '%s'\n", current_token->lexeme);
-            advance();
-        }
-    }
-    
-    if (!match(DELIMITER, "}")) {
-        recordError("Missing '}' to close a block");
-    } else {
-        fprintf(parse_output, "  BLOCK closed properly.\n");
-    }
-    
-    fprintf(parse_output, "  BLOCK parsing done.\n");
-}
-
-void parseStatement() {
-    if (current_token == NULL) {
-        recordError("Unexpected end of code");
-        return;
-    }
-    
-    // Save position to check for 'if' keyword that might be classified as IDENTIFIER
-    bool is_if_keyword = (current_token->type == IDENTIFIER && 
-                          strcmp(current_token->lexeme, "if") == 0);
-    
-    // Declaration statement
-    if (isScopeModifier() || isDataType() || check(KEYWORDS, "cons")) {
-        parseDecStmt();
-    }
-    // Conditional statement - check for 'if' as IDENTIFIER too
-    else if (check(KEYWORDS, "do") || check(KEYWORDS, "compare") || 
-             (check(KEYWORDS, "if") || is_if_keyword)) {
-        parseConditionalStmt();
-    }
-    // Iterative statement
-    else if (check(KEYWORDS, "continue") || check(KEYWORDS, "stop")) {
-        parseIterativeStmt();
-    }
-    // Output statement
-    else if (check(KEYWORDS, "display")) {
-        parseOutputStmt();
-    }
-    // Input statement
-    else if (check(KEYWORDS, "put")) {
-        parseInputStmt();
-    }
-    // Break statement
-    else if (check(KEYWORDS, "break") || check(KEYWORDS, "back")) {
-        parseBreakStmt();
-    }
-    // Assignment statement
-    else if (checkType(IDENTIFIER)) {
-        parseAssStmt();
-    }
-    else {
-        recordError("This doesn't look like a valid statement");
-        skipToSemicolon(); // Recovery: skip to next statement
-    }
-}
-
-void parseDecStmt() {
-    // Check for 'cons' (constant)
-    if (match(KEYWORDS, "cons")) {
-        if (!isDataType()) {
-            recordError("Missing data type after 'cons' (like int, float, text)");
-            skipToSemicolon();
-            return;
-        }
-        advance();
-        
-        if (!matchType(IDENTIFIER)) {
-            recordError("Missing variable name after data type");
-            skipToSemicolon();
-            return;
-        }
-        
-        if (!match(OPERATION, "=")) {
-            recordError("Constant needs '=' and a value");
-            skipToSemicolon();
-            return;
-        }
-        
-        parseExpr();
-        
-        if (!match(DELIMITER, ";")) {
-            recordError("Missing ';' at the end of this line");
-            skipToSemicolon();
-        }
-        return;
-    }
-    
-    // Optional scope modifier
-    if (isScopeModifier()) {
-        advance();
-    }
-    
-    // Data type (required)
-    if (!isDataType()) {
-        recordError("Missing data type (like int, float, text)");
-        skipToSemicolon();
-        return;
-    }
-    advance();
-    
-    if (!matchType(IDENTIFIER)) {
-        recordError("Missing variable name");
-        skipToSemicolon();
-        return;
-    }
-    
-    // Check what comes next
-    if (match(OPERATION, "=")) {
-        parseExpr();
-        
-        while (match(DELIMITER, ",")) {
-            if (!matchType(IDENTIFIER)) {
-                recordError("Missing variable name after ','");
-                skipToSemicolon();
-                return;
-            }
-            if (match(OPERATION, "=")) {
-                parseExpr();
-            }
-        }
-        
-        if (!match(DELIMITER, ";")) {
-            recordError("Missing ';' at the end of this line");
-            skipToSemicolon();
-        }
-    }
-    else if (match(DELIMITER, ",")) {
-        parseIdList();
-        if (!match(DELIMITER, ";")) {
-            recordError("Missing ';' at the end of this line");
-            skipToSemicolon();
-        }
-    }
-    else if (match(DELIMITER, ";")) {
-        // Simple declaration is fine
-    }
-    else {
-        recordError("Expected ';', '=', or ',' after variable name");
-        skipToSemicolon();
-    }
-}
-
-void parseIdList() {
-    if (!matchType(IDENTIFIER)) {
-        recordError("Missing variable name in the list");
-        return;
-    }
-    
-    if (match(OPERATION, "=")) {
-        parseExpr();
-    }
-    
-    while (match(DELIMITER, ",")) {
-        if (!matchType(IDENTIFIER)) {
-            recordError("Missing variable name after ','");
-            return;
-        }
-        if (match(OPERATION, "=")) {
-            parseExpr();
-        }
-    }
-}
-
-void parseAssStmt() {
-    if (!matchType(IDENTIFIER)) {
-        recordError("Missing variable name");
-        skipToSemicolon();
-        return;
-    }
-    
-    // Check for assignment operators
-    if (!(check(OPERATION, "=") || check(OPERATION, "+=") || check(OPERATION, "-=") ||
-          check(OPERATION, "*=") || check(OPERATION, "/=") || check(OPERATION, "%="))) {
-        recordError("Missing '=' for assignment");
-        skipToSemicolon();
-        return;
-    }
-    
-    // Consume the assignment operator
-    advance();
-    
-    parseExpr();
-    
-    if (!match(DELIMITER, ";")) {
-        recordError("Missing ';' at the end of this line");
-        skipToSemicolon();
-    }
-}
-
-void parseConditionalStmt() {
-
-    // BLOCK 1: 'do if' (The Conditional)
-    if (match(KEYWORDS, "do")) {
-        
-        // 1. Handle 'if' 
-        bool matched_if = false;
-        if (match(KEYWORDS, "if")) {
-            matched_if = true;
-        } else if (current_token != NULL && current_token->type == IDENTIFIER && 
-                   strcmp(current_token->lexeme, "if") == 0) {
-            advance();
-            matched_if = true;
-        }
-        
-        // If we found 'do' but NO 'if'
-        if (!matched_if) {
-            
-            recordError("Missing 'if' after 'do'");
-            skipToSemicolon();
-            return;
-        }
-        
-        // 2. Parse Condition: ( expr )
-        if (!match(DELIMITER, "(")) {
-            recordError("Missing '(' after 'if'");
-            skipToSemicolon();
-            return;
-        }
-        
-        parseExpr();
-        
-        if (!match(DELIMITER, ")")) {
-            recordError("Missing ')' after condition");
-        }
-        
-        // 3. Parse Body: { block } or statement
-        if (check(DELIMITER, "{")) {
-            parseBlock();
-        } else {
-            parseStatement();
-        }
-        
-        // BLOCK 2: 'then do', The "Else" Substitute
-        
-        // Check for 'then' as Keyword OR Identifier
-        bool matched_then = false;
-        if (match(KEYWORDS, "then")) {
-            matched_then = true;
-        } else if (current_token != NULL && current_token->type == IDENTIFIER && 
-                   strcmp(current_token->lexeme, "then") == 0) {
-            advance();
-            matched_then = true;
-        }
-
-        if (matched_then) {
-            // We found 'then', now we MUST find 'do'
-            bool matched_else_do = false;
-            
-            if (match(KEYWORDS, "do")) {
-                matched_else_do = true;
-            } else if (current_token != NULL && current_token->type == IDENTIFIER && 
-                       strcmp(current_token->lexeme, "do") == 0) {
-                advance();
-                matched_else_do = true;
-            }
-
-            if (!matched_else_do) {
-                recordError("Missing 'do' after 'then'");
-            } else {
-                // Parse the Else Body
-                if (check(DELIMITER, "{")) {
-                    parseBlock();
-                } else {
-                    parseStatement();
-                }
-            }
-        }
-    }
-    
-    // BLOCK 3: 'compare' (Switch Case)
-    
-    else if (match(KEYWORDS, "compare")) {
-        parseExpr();
-        
-        if (!match(DELIMITER, "{")) {
-            recordError("Missing '{' after compare");
-            return;
-        }
-        
-        while (match(KEYWORDS, "what")) {
-            if (!match(KEYWORDS, "if")) {
-                recordError("Missing 'if' after 'what'");
-                continue;
-            }
-            
-            parseExpr();
-            
-            if (!match(DELIMITER, ":")) {
-                recordError("Missing ':' after case value");
-            }
-            
-            while (current_token != NULL && !check(KEYWORDS, "break") && 
-                   !check(KEYWORDS, "what") && !check(KEYWORDS, "then") &&
-                   !check(DELIMITER, "}")) {
-                parseStatement();
-            }
-            
-            if (!match(KEYWORDS, "break")) {
-                recordError("Missing 'break' at end of case");
-            }
-            if (!match(DELIMITER, ";")) {
-                recordError("Missing ';' after 'break'");
-            }
-        }
-        
-        if (match(KEYWORDS, "then")) {
-            if (!match(KEYWORDS, "do")) {
-                recordError("Missing 'do' after 'then'");
-            }
-            if (!match(DELIMITER, ":")) {
-                recordError("Missing ':' after 'then do'");
-            }
-            
-            while (current_token != NULL && !check(DELIMITER, "}")) {
-                parseStatement();
-            }
-        }
-        
-        if (!match(DELIMITER, "}")) {
-            recordError("Missing '}' at end of compare");
-        }
-    }
-    // Handle standalone 'if' (in case it's classified as IDENTIFIER)
-    else if (current_token != NULL && current_token->type == IDENTIFIER && 
-             strcmp(current_token->lexeme, "if") == 0) {
-        // This is 'if' without 'do', treat as error or allow it
-        recordError("Found 'if' without 'do' before it");
-        advance();
-        
-        if (!match(DELIMITER, "(")) {
-            recordError("Missing '(' after 'if'");
-            skipToSemicolon();
-            return;
-        }
-        
-        parseExpr();
-        
-        if (!match(DELIMITER, ")")) {
-            recordError("Missing ')' after condition");
-        }
-        
-        if (check(DELIMITER, "{")) {
-            parseBlock();
-        } else {
-            parseStatement();
-        }
-    }
-}
-
-void parseIterativeStmt() {
-    if (match(KEYWORDS, "continue")) {
-        if (!match(KEYWORDS, "until")) {
-            recordError("Missing 'until' after 'continue'");
-            skipToSemicolon();
-            return;
-        }
-        
-        if (!match(DELIMITER, "(")) {
-            recordError("Missing '(' after 'until'");
-            skipToSemicolon();
-            return;
-        }
-        
-        parseExpr();
-        
-        if (match(DELIMITER, ";")) {
-            parseExpr();
-            
-            if (!match(DELIMITER, ";")) {
-                recordError("Missing ';' in loop");
-            }
-            
-            parseExpr();
-        }
-        
-        if (!match(DELIMITER, ")")) {
-            recordError("Missing ')' after loop condition");
-        }
-        
-        if (check(DELIMITER, "{")) {
-            parseBlock();
-        } else {
-            parseStatement();
-        }
-    }
-    else if (match(KEYWORDS, "stop")) {
-        if (!match(KEYWORDS, "when")) {
-            recordError("Missing 'when' after 'stop'");
-            skipToSemicolon();
-            return;
-        }
-        
-        if (!match(DELIMITER, "(")) {
-            recordError("Missing '(' after 'when'");
-            skipToSemicolon();
-            return;
-        }
-        
-        parseExpr();
-        
-        if (!match(DELIMITER, ")")) {
-            recordError("Missing ')' after condition");
-        }
-        
-        if (check(DELIMITER, "{")) {
-            parseBlock();
-        } else {
-            parseStatement();
-        }
-    }
-}
-
-void parseOutputStmt() {
-    if (!match(KEYWORDS, "display")) {
-        recordError("Missing 'display' keyword");
-        skipToSemicolon();
-        return;
-    }
-    
-    parseExprList();
-    
-    if (!match(DELIMITER, ";")) {
-        recordError("Missing ';' at the end of display");
-        skipToSemicolon();
-    }
-}
-
-void parseInputStmt() {
-    if (!match(KEYWORDS, "put")) {
-        recordError("Missing 'put' keyword");
-        skipToSemicolon();
-        return;
-    }
-    
-    if (!matchType(IDENTIFIER)) {
-        recordError("Missing variable name after 'put'");
-        skipToSemicolon();
-        return;
-    }
-    
-    if (!match(DELIMITER, ";")) {
-        recordError("Missing ';' at the end of put");
-        skipToSemicolon();
-    }
-}
-
-void parseBreakStmt() {
-    if (match(KEYWORDS, "break") || match(KEYWORDS, "back")) {
-        if (!match(DELIMITER, ";")) {
-            recordError("Missing ';' after break/back");
-            skipToSemicolon();
-        }
-    }
-}
-
-void parseExprList() {
-    parseExpr();
-    
-    while (match(DELIMITER, ",")) {
-        parseExpr();
-    }
-}
-
-void parseExpr() {
-    parseLogicalOrExpr();
-}
-
-void parseLogicalOrExpr() {
-    parseLogicalAndExpr();
-    while (match(OPERATION, "||")) {
-        parseLogicalAndExpr();
-    }
-}
-
-void parseLogicalAndExpr() {
-    parseEqualityExpr();
-    while (match(OPERATION, "&&")) {
-        parseEqualityExpr();
-    }
-}
-
-void parseEqualityExpr() {
-    parseRelationalExpr();
-    while (match(OPERATION, "==") || match(OPERATION, "!=")) {
-        parseRelationalExpr();
-    }
-}
-
-void parseRelationalExpr() {
-    parseAdditiveExpr();
-    while (match(OPERATION, "<") || match(OPERATION, ">") || 
-           match(OPERATION, "<=") || match(OPERATION, ">=")) {
-        parseAdditiveExpr();
-    }
-}
-
-void parseAdditiveExpr() {
-    parseMultiplicativeExpr();
-    while (match(OPERATION, "+") || match(OPERATION, "-")) {
-        parseMultiplicativeExpr();
-    }
-}
-
-void parseMultiplicativeExpr() {
-    parseUnaryExpr();
-    while (match(OPERATION, "*") || match(OPERATION, "/") || match(OPERATION, "%")) {
-        parseUnaryExpr();
-    }
-}
-
-void parseUnaryExpr() {
-    if (match(OPERATION, "+") || match(OPERATION, "-") || 
-        match(OPERATION, "!") || match(OPERATION, "++") || match(OPERATION, "--")) {
-        parseUnaryExpr();
-    } else {
-        parsePostfixExpr();
-    }
-}
-
-void parsePostfixExpr() {
-    parsePrimaryExpr();
-    while (match(OPERATION, "++") || match(OPERATION, "--")) {
-        // Postfix operators handled
-    }
-}
-
-void parsePrimaryExpr() {
-    if (matchType(IDENTIFIER)) {
-        return;
-    }
-    else if (matchType(CONSTANT)) {
-        return;
-    }
-    else if (checkType(RESERVED_WORDS)) {
-        advance();
-        return;
-    }
-    else if (match(DELIMITER, "(")) {
-        parseExpr();
-        if (!match(DELIMITER, ")")) {
-            recordError("Missing ')' in expression");
-        }
-        return;
-    }
-    else {
-        recordError("Invalid expression");
-        // Try to recover
-        advance();
-    }
-}
-
-void printTokenStatistics(void) {
-    const char* names[] = {
-        "IDENTIFIER",
-        "OPERATION",
-        "KEYWORDS",
-        "RESERVED_WORDS",
-        "CONSTANT",
-        "NOISE_WORDS",
-        "COMMENT",
-        "WHITE_SPACE",
-        "DELIMITER"
-    };
-    fprintf(parse_output, "=== TOKEN STATISTICS ===\n");
-    printf("=== TOKEN STATISTICS ===\n");
-    int max = DELIMITER;
-    for (int i = 0; i <= max; i++) {
-        fprintf(parse_output, "  %s: %d\n", names[i], token_counts[i]);
-        printf("  %s: %d\n", names[i], token_counts[i]);
-    }
-    fprintf(parse_output, "  Total tokens: %d\n\n", total_tokens);
-    printf("  Total tokens: %d\n\n", total_tokens);
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include "source.h"
+#include "tokens.h"
+#include "parser.h"
+
+// Function prototypes
+void readTokensFromFile(Parser* parser, const char* filename, SourceBuffer* stream);
+bool nextArrayToken(void* context, Token* token);
+size_t nextTokenBit(const uint64_t* bits, size_t words, size_t from, size_t none);
+bool loadRecoveryIndex(Parser* parser);
+size_t braceRank(const RecoveryIndex* index, size_t token);
+size_t matchingBrace(const RecoveryIndex* index, size_t token);
+void takeTrivia(Parser* parser, uint64_t offset, bool count);
+bool pullToken(Parser* parser, Token* token);
+Token* fetchToken(Parser* parser);
+void jumpToToken(Parser* parser, size_t index);
+const char* tokenText(Parser* parser, const Token* token, int* length);
+const char* copyErrorText(Parser* parser, const char* text, size_t length);
+const char* copySourceLine(Parser* parser, const Token* token);
+void advance(Parser* parser);
+bool match(Parser* parser, TokenKind kind);
+bool matchType(Parser* parser, TokenType type);
+bool check(Parser* parser, TokenKind kind);
+bool checkType(Parser* parser, TokenType type);
+void recordError(Parser* parser, const char* message);
+void skipToSemicolon(Parser* parser);
+void skipToCloseBrace(Parser* parser);
+void startParallelParse(Parser* parser, int threads);
+void finishParallelParse(Parser* parser);
+bool spliceChunk(Parser* parser);
+bool pushFrame(Parser* parser, int state);
+void freeParseStack(Parser* parser);
+void skipNested(Parser* parser);
+void skipParenthesized(Parser* parser);
+void skipExpression(Parser* parser);
+void pushStatement(Parser* parser);
+void pushBody(Parser* parser);
+void skipStuckToken(Parser* parser, size_t before);
+void openBlock(Parser* parser);
+void closeBlock(Parser* parser);
+void runStatements(Parser* parser, size_t base);
+
+// Grammar rule functions
+void parseProgram(Parser* parser);
+void parseBlock(Parser* parser);
+void parseBlockStatement(Parser* parser);
+void parseStatement(Parser* parser);
+void beginStatement(Parser* parser);
+void parseDecStmt(Parser* parser);
+void parseAssStmt(Parser* parser);
+void parseConditionalStmt(Parser* parser);
+void parseIterativeStmt(Parser* parser);
+void parseOutputStmt(Parser* parser);
+void parseInputStmt(Parser* parser);
+void parseBreakStmt(Parser* parser);
+void parseExpr(Parser* parser);
+void parsePrimaryExpr(Parser* parser);
+void parseIdList(Parser* parser);
+void parseExprList(Parser* parser);
+bool isDataType(Parser* parser);
+bool isScopeModifier(Parser* parser);
+void printTokenStatistics(Parser* parser);
+void echoPrintf(Parser* parser, const char* format, ...);
+
+#ifndef LEXC_DRIVER
+int main() {
+    Parser parser;
+    SourceBuffer token_stream;
+    Arena arena;
+    
+    initArena(&arena);
+    initParser(&parser, &arena);
+    
+    // Read tokens from the lexer's token stream
+    readTokensFromFile(&parser, "SymbolTable.bin", &token_stream);
+    
+    // Open output file for parse results
+    FILE* output = fopen("ParseOutput.txt", "w");
+    if (output == NULL) {
+        fprintf(stderr, "Error: Cannot create ParseOutput.txt\n");
+        return 1;
+    }
+    
+#ifndef _WIN32
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    long threads = 1;
+#endif
+    int errors_found = syntaxAnalyzerParallel(&parser, output, stdout, threads > 1 ? (int)threads : 1);
+    
+    fclose(output);
+    printf("\nResults saved to 'ParseOutput.txt'\n");
+    releaseSourceFile(&token_stream);
+    freeArena(&arena);
+    
+    return errors_found > 0 ? 1 : 0;
+}
+#endif
+
+// Parse the loaded tokens, writing the report to output and a summary to
+// echo (NULL for none); returns the error count
+int syntaxAnalyzer(Parser* parser, FILE* output, FILE* echo) {
+    return syntaxAnalyzerParallel(parser, output, echo, 1);
+}
+
+// As syntaxAnalyzer(), with the same report, but with large blocks of a
+// loaded token array split into pieces that up to threads threads parse at
+// once (see startParallelParse)
+int syntaxAnalyzerParallel(Parser* parser, FILE* output, FILE* echo, int threads) {
+    parser->output = output;
+    parser->echo = echo;
+       
+    // Start syntax analysis
+    fprintf(parser->output, "=== SYNTAX ANALYSIS ===\n\n");
+    echoPrintf(parser, "Starting syntax analysis...\n");
+    echoPrintf(parser, "Using: Recursive Descent Parser with Panic Mode Recovery\n\n");
+    
+    parser->current_index = 0;
+    parser->current_token = fetchToken(parser);
+    
+    startParallelParse(parser, threads);
+    parseProgram(parser);
+    finishParallelParse(parser);
+    freeParseStack(parser);
+    
+    // Tokens after the program still count towards the statistics
+    while (parser->current_token != NULL) {
+        advance(parser);
+    }
+    printTokenStatistics(parser);
+    
+    // Display all errors at the end
+    fprintf(parser->output, "\n=== ANALYSIS COMPLETE ===\n\n");
+    
+    if (parser->error_count == 0) {
+        fprintf(parser->output, "SUCCESS: Your code has no syntax errors.\n");
+        echoPrintf(parser, "\n SUCCESS: Your code has no syntax errors.\n");
+    } else {
+        fprintf(parser->output, " FOUND %d ERROR(S):\n\n", parser->error_count);
+        echoPrintf(parser, "\n FOUND %d ERROR(S):\n\n", parser->error_count);
+        
+        for (int i = 0; i < parser->error_count; i++) {
+            fprintf(parser->output, "Error %d (Line %lld, Column %lld):\n", 
+                    i + 1, parser->errors[i].line, parser->errors[i].column);
+            fprintf(parser->output, "  Problem: %s\n", parser->errors[i].message);
+            fprintf(parser->output, "  Found: '%s'\n", parser->errors[i].found);
+            if (parser->errors[i].code[0] != '\0') {
+                fprintf(parser->output, "  Code: %s\n", parser->errors[i].code);
+            }
+            fprintf(parser->output, "\n");
+            
+            echoPrintf(parser, "Error %d (Line %lld, Column %lld):\n", 
+                   i + 1, parser->errors[i].line, parser->errors[i].column);
+            echoPrintf(parser, "  Problem: %s\n", parser->errors[i].message);
+            echoPrintf(parser, "  Found: '%s'\n", parser->errors[i].found);
+            if (parser->errors[i].code[0] != '\0') {
+                echoPrintf(parser, "  Code: %s\n", parser->errors[i].code);
+            }
+            echoPrintf(parser, "\n");
+        }
+        
+        fprintf(parser->output, "Total: %d error(s) need to be fixed\n", parser->error_count);
+        echoPrintf(parser, "Total: %d error(s) need to be fixed\n", parser->error_count);
+    }
+    
+    return parser->error_count;
+}
+
+// Start a parser whose error records are kept in arena. The caller owns the
+// arena and may reset it once a report has been written.
+void initParser(Parser* parser, Arena* arena) {
+    memset(parser, 0, sizeof(*parser));
+    parser->arena = arena;
+    parser->max_depth = PARSE_MAX_DEPTH;
+}
+
+// Pull tokens from next(context) on demand. text is the input the token
+// spans point into and may be a window that the source slides forward;
+// trivia, if not NULL, holds the whitespace and comments before each token
+// by the time it is returned, as entries or as a tally;
+// lines is the line-start table, which must hold the line of each token by
+// the time it is returned, or NULL if errors are reported without a position.
+void setTokenSource(Parser* parser, NextTokenFn next, void* context, const SourceText* text,
+                    TriviaBuffer* trivia, const LineIndex* lines) {
+    parser->token_source = next;
+    parser->token_source_context = context;
+    parser->source_text = text;
+    parser->trivia = trivia;
+    parser->trivia_next = 0;
+    parser->lines = lines;
+    parser->tokens_counted = false;
+    memset(&parser->recovery, 0, sizeof(parser->recovery));
+    
+    parser->current_token = NULL;
+    parser->current_index = 0;
+    parser->error_count = 0;
+    parser->total_tokens = 0;
+    parser->name_count = 0;
+    memset(parser->token_counts, 0, sizeof(parser->token_counts));
+}
+
+// Parse an in-memory token array and its trivia; both must outlive the parse
+void loadTokens(Parser* parser, const Token* tokens, size_t count, const Trivia* trivia, size_t trivia_count,
+                const char* text, size_t text_size, const uint64_t* lines, size_t lines_count) {
+    parser->token_array.tokens = tokens;
+    parser->token_array.count = count;
+    parser->token_array.next = 0;
+    parser->whole_text.data = text;
+    parser->whole_text.offset = 0;
+    parser->whole_text.size = text_size;
+    memset(&parser->whole_trivia, 0, sizeof(parser->whole_trivia));
+    parser->whole_trivia.trivia = (Trivia*)trivia;  // only read
+    parser->whole_trivia.count = trivia_count;
+    parser->whole_trivia.capacity = trivia_count;
+    parser->whole_lines.starts = (uint64_t*)lines;  // only read
+    parser->whole_lines.count = lines_count;
+    parser->whole_lines.capacity = lines_count;
+    parser->whole_lines.first_line = 1;
+    parser->whole_lines.cut_line = 0;
+    parser->whole_lines.cut_tabs = 0;
+    parser->whole_lines.failed = false;
+    setTokenSource(parser, nextArrayToken, &parser->token_array, &parser->whole_text, &parser->whole_trivia,
+                   lines != NULL ? &parser->whole_lines : NULL);
+}
+
+bool nextArrayToken(void* context, Token* token) {
+    TokenArray* array = (TokenArray*)context;
+    if (array->next >= array->count) return false;
+    *token = array->tokens[array->next++];
+    return true;
+}
+
+// Index of the first set bit at or after bit from, or none
+size_t nextTokenBit(const uint64_t* bits, size_t words, size_t from, size_t none) {
+    size_t w = from / 64;
+    if (w >= words) return none;
+    uint64_t word = bits[w] & (~(uint64_t)0 << (from % 64));
+    while (word == 0) {
+        if (++w == words) return none;
+        word = bits[w];
+    }
+    return w * 64 + (size_t)__builtin_ctzll(word);
+}
+
+// Build the recovery index of a loaded array the first time recovery needs
+// it. One forward pass marks each ';' and '}' and each brace, one bit per
+// token, and lists the braces in order. A backward pass over the braces
+// alone then gives each one its landing place for skipToCloseBrace: the
+// first '}' at or after it that no '{' at or after it opened. A '}' in that
+// pass is pushed on a stack threaded through the table itself: below a '}'
+// at b lies close[b + 1], so a '{' pops its match b and lands on
+// close[b + 1].
+// Recovery then jumps over tokens without pulling them, so the forward pass
+// also takes the statistics afresh for the whole input, as pulling every
+// token would. The parse always runs to the end of the input, so the totals
+// do not depend on the path it takes.
+bool loadRecoveryIndex(Parser* parser) {
+    RecoveryIndex* index = &parser->recovery;
+    const Token* tokens = parser->token_array.tokens;
+    size_t count = parser->token_array.count;
+    
+    if (index->stops != NULL) return true;
+    if (parser->token_source != nextArrayToken || count == 0 || count >= UINT32_MAX) return false;
+    
+    if (parser->arena->failed) return false;   // recovery steps token by token instead
+    
+    index->words = (count + 63) / 64;
+    index->stops = (uint64_t*)arenaAlloc(parser->arena, index->words * sizeof(uint64_t));
+    index->braces = (uint64_t*)arenaAlloc(parser->arena, index->words * sizeof(uint64_t));
+    index->brace_rank = (uint32_t*)arenaAlloc(parser->arena, index->words * sizeof(uint32_t));
+    if (index->stops == NULL || index->braces == NULL || index->brace_rank == NULL) {
+        index->stops = NULL;
+        return false;
+    }
+    memset(index->stops, 0, index->words * sizeof(uint64_t));
+    memset(index->braces, 0, index->words * sizeof(uint64_t));
+    
+    size_t end = count;
+    size_t brace_count = 0;
+    parser->total_tokens = 0;
+    parser->name_count = 0;
+    memset(parser->token_counts, 0, sizeof(parser->token_counts));
+    for (size_t i = 0; i < count; i++) {
+        const Token* token = &tokens[i];
+        uint64_t bit = (uint64_t)1 << (i % 64);
+        if (i % 64 == 0) {
+            index->brace_rank[i / 64] = (uint32_t)brace_count;
+        }
+        if (token->kind == TK_UNTERMINATED_STRING) {
+            // Neither it nor anything after it is pulled
+            end = i;
+            break;
+        }
+        if (token->kind == TK_SEMICOLON) {
+            index->stops[i / 64] |= bit;
+        } else if (token->kind == TK_RBRACE) {
+            index->stops[i / 64] |= bit;
+            index->braces[i / 64] |= bit;
+            brace_count++;
+        } else if (token->kind == TK_LBRACE) {
+            index->braces[i / 64] |= bit;
+            brace_count++;
+        }
+        parser->total_tokens++;
+        if (token->name_id > parser->name_count) {
+            parser->name_count = token->name_id;
+        }
+        if (token->type <= DELIMITER) {
+            parser->token_counts[token->type]++;
+        }
+    }
+    for (size_t w = end / 64 + 1; w < index->words; w++) {
+        index->brace_rank[w] = (uint32_t)brace_count;
+    }
+    parser->trivia_next = 0;
+    takeTrivia(parser, end < count ? tokens[end].start : UINT64_MAX, true);
+    parser->trivia_next = parser->trivia != NULL ? parser->trivia->count : 0;
+    parser->tokens_counted = true;
+    
+    index->end = (uint32_t)end;
+    index->brace_count = (uint32_t)brace_count;
+    index->brace_token = (uint32_t*)arenaAlloc(parser->arena, (brace_count + 1) * sizeof(uint32_t));
+    index->brace_close = (uint32_t*)arenaAlloc(parser->arena, (brace_count + 1) * sizeof(uint32_t));
+    if (index->brace_token == NULL || index->brace_close == NULL) {
+        // The statistics just taken stand; tokens are now pulled without them
+        index->stops = NULL;
+        return false;
+    }
+    size_t b = 0;
+    for (size_t i = nextTokenBit(index->braces, index->words, 0, end); i < end;
+         i = nextTokenBit(index->braces, index->words, i + 1, end)) {
+        index->brace_token[b++] = (uint32_t)i;
+    }
+    index->brace_token[brace_count] = (uint32_t)end;   // where an unclosed '{' lands
+    index->brace_close[brace_count] = (uint32_t)brace_count;
+    for (size_t k = brace_count; k-- > 0;) {
+        if (tokens[index->brace_token[k]].kind == TK_RBRACE) {
+            index->brace_close[k] = (uint32_t)k;
+        } else {
+            uint32_t match = index->brace_close[k + 1];
+            index->brace_close[k] = match < brace_count ? index->brace_close[match + 1] : match;
+        }
+    }
+    return true;
+}
+
+// Braces before token index token
+size_t braceRank(const RecoveryIndex* index, size_t token) {
+    uint64_t below = ((uint64_t)1 << (token % 64)) - 1;
+    return index->brace_rank[token / 64] + (size_t)__builtin_popcountll(index->braces[token / 64] & below);
+}
+
+// Token index of the '}' that closes the '{' at token, or index->end. Below
+// the '{' at rank k, brace_close[k + 1] is its match.
+size_t matchingBrace(const RecoveryIndex* index, size_t token) {
+    size_t rank = braceRank(index, token) + 1;
+    return index->brace_token[rank < index->brace_count ? index->brace_close[rank] : index->brace_count];
+}
+
+// Map the lexer's binary token stream into stream and parse its sections in place
+void readTokensFromFile(Parser* parser, const char* filename, SourceBuffer* stream) {
+    const TokenStreamHeader* header;
+    
+    if (!loadSourceFile(filename, stream, SOURCE_BINARY)) {
+        fprintf(stderr, "Error: Cannot open %s\n", filename);
+        exit(1);
+    }
+    
+    header = (const TokenStreamHeader*)stream->data;
+    if (stream->size < sizeof(TokenStreamHeader) ||
+        memcmp(header->magic, TOKEN_STREAM_MAGIC, sizeof(header->magic)) != 0) {
+        fprintf(stderr, "Error: %s is not a token stream\n", filename);
+        exit(1);
+    }
+    if (header->version != TOKEN_STREAM_VERSION || header->token_size != sizeof(Token)) {
+        fprintf(stderr, "Error: %s has token stream version %u, expected %d\n",
+                filename, (unsigned)header->version, TOKEN_STREAM_VERSION);
+        exit(1);
+    }
+    if (header->tokens_offset % 8 != 0 || header->lines_offset % 8 != 0 ||
+        header->tokens_offset > stream->size ||
+        header->token_count > (stream->size - header->tokens_offset) / sizeof(Token) ||
+        header->text_offset > stream->size ||
+        header->text_size > stream->size - header->text_offset ||
+        header->lines_offset > stream->size ||
+        header->line_count > (stream->size - header->lines_offset) / sizeof(uint64_t) ||
+        header->trivia_offset % 8 != 0 || header->trivia_offset > stream->size ||
+        header->trivia_count > (stream->size - header->trivia_offset) / sizeof(Trivia)) {
+        fprintf(stderr, "Error: %s is truncated or corrupt\n", filename);
+        exit(1);
+    }
+    
+    const Token* tokens = (const Token*)(stream->data + header->tokens_offset);
+    for (size_t i = 0; i < header->token_count; i++) {
+        const Token* tok = &tokens[i];
+        if (tok->kind >= TK_COUNT || tok->start > header->text_size ||
+            tok->length > header->text_size - tok->start) {
+            fprintf(stderr, "Error: %s has an invalid token at index %zu\n", filename, i);
+            exit(1);
+        }
+    }
+    const Trivia* trivia = (const Trivia*)(stream->data + header->trivia_offset);
+    for (size_t i = 0; i < header->trivia_count; i++) {
+        const Trivia* entry = &trivia[i];
+        if ((entry->kind != TK_WHITE_SPACE && entry->kind != TK_COMMENT) || entry->start > header->text_size ||
+            entry->length > header->text_size - entry->start) {
+            fprintf(stderr, "Error: %s has invalid trivia at index %zu\n", filename, i);
+            exit(1);
+        }
+    }
+    
+    loadTokens(parser, tokens, (size_t)header->token_count, trivia, (size_t)header->trivia_count,
+               stream->data + header->text_offset, (size_t)header->text_size,
+               (const uint64_t*)(stream->data + header->lines_offset),
+               (size_t)header->line_count);
+}
+
+// Step past the whitespace and comments that start before offset, counting
+// them in the statistics (one token per whitespace byte) if count is set. A
+// tally only ever holds what came before the token just pulled, so it is
+// taken whole and cleared.
+void takeTrivia(Parser* parser, uint64_t offset, bool count) {
+    TriviaBuffer* trivia = parser->trivia;
+    if (trivia == NULL) return;
+    
+    if (trivia->tally_only) {
+        if (count) {
+            parser->total_tokens += trivia->whitespace + trivia->comments;
+            parser->token_counts[WHITE_SPACE] += trivia->whitespace;
+            parser->token_counts[COMMENT] += trivia->comments;
+        }
+        trivia->whitespace = 0;
+        trivia->comments = 0;
+        return;
+    }
+    while (parser->trivia_next < trivia->count && trivia->trivia[parser->trivia_next].start < offset) {
+        const Trivia* entry = &trivia->trivia[parser->trivia_next++];
+        if (count) {
+            uint64_t tokens = entry->kind == TK_WHITE_SPACE ? entry->length : 1;
+            parser->total_tokens += tokens;
+            parser->token_counts[token_kind_type[entry->kind]] += tokens;
+        }
+    }
+}
+
+// Pull the next raw token, keeping the statistics unless recovery has
+// already taken them for the whole input. A string literal is
+// already one TK_STRING token; an unterminated one swallows the rest of the
+// input.
+bool pullToken(Parser* parser, Token* token) {
+    if (!parser->token_source(parser->token_source_context, token)) {
+        takeTrivia(parser, UINT64_MAX, true);
+        return false;
+    }
+    takeTrivia(parser, token->start, true);
+    if (token->kind == TK_UNTERMINATED_STRING) {
+        takeTrivia(parser, UINT64_MAX, false);
+        return false;
+    }
+    if (parser->tokens_counted) return true;
+    
+    parser->total_tokens++;
+    if (token->name_id > parser->name_count) {
+        parser->name_count = token->name_id;
+    }
+    if (token->type <= DELIMITER) {
+        parser->token_counts[token->type]++;
+    }
+    return true;
+}
+
+// Pull the next token into the ring; whitespace and comments never reach it
+Token* fetchToken(Parser* parser) {
+    Token* slot = &parser->token_ring[parser->current_index % TOKEN_RING_SIZE];
+    if (!pullToken(parser, slot)) return NULL;
+    parser->current_index++;
+    return slot;
+}
+
+// Make token index of the loaded array the current one, as if every token
+// before it had been stepped over with advance()
+void jumpToToken(Parser* parser, size_t index) {
+    size_t current = parser->token_array.next - 1;
+    if (index == current) return;
+    parser->current_index += index - current - 1;
+    parser->token_array.next = index;
+    parser->current_token = fetchToken(parser);
+}
+
+// The part of a token's lexeme that is still buffered
+const char* tokenText(Parser* parser, const Token* token, int* length) {
+    uint64_t end = parser->source_text->offset + parser->source_text->size;
+    
+    if (token->start < parser->source_text->offset || token->start >= end) {
+        *length = 0;
+        return "";
+    }
+    uint64_t available = end - token->start;
+    *length = (int)(token->length < available ? token->length : available);
+    return parser->source_text->data + (token->start - parser->source_text->offset);
+}
+
+// Copy length bytes of text into the parser's arena, as snprintf would into
+// a MAX_TOKEN_LEN buffer: cut short at a NUL or MAX_TOKEN_LEN - 1 bytes
+const char* copyErrorText(Parser* parser, const char* text, size_t length) {
+    length = strnlen(text, length < MAX_TOKEN_LEN - 1 ? length : MAX_TOKEN_LEN - 1);
+    char* copy = (char*)arenaAlloc(parser->arena, length + 1);
+    if (copy == NULL) return "";   // the arena records the failure for the driver
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Copy the source line a token is on, as far as it is still buffered. A
+// line that starts before the window is marked as cut there.
+const char* copySourceLine(Parser* parser, const Token* token) {
+    const char* text = parser->source_text->data;
+    uint64_t first = parser->source_text->offset;
+    uint64_t last = parser->source_text->offset + parser->source_text->size;
+    size_t line = parser->lines != NULL ? findLine(parser->lines, token->start) : 0;
+    uint64_t start, end;
+    
+    if (token->start < first || token->start > last) return NOT_BUFFERED;
+    
+    if (parser->lines != NULL && line + 1 < parser->lines->count) {
+        start = parser->lines->starts[line];
+        end = parser->lines->starts[line + 1];
+    } else {
+        start = parser->lines != NULL && line < parser->lines->count ? parser->lines->starts[line] : token->start;
+        if (start >= first) {
+            while (start > first && text[start - 1 - first] != '\n') {
+                start--;
+            }
+        }
+        const char* newline = memchr(text + (token->start - first), '\n', last - token->start);
+        end = newline ? first + (uint64_t)(newline - text) : last;
+    }
+    if (end > last) return "";
+    while (end > start && end > first && (text[end - 1 - first] == '\n' || text[end - 1 - first] == '\r')) {
+        end--;
+    }
+    if (start < first) {
+        const char* rest = copyErrorText(parser, text, (size_t)(end - first));
+        size_t length = strlen(rest);
+        char* code = (char*)arenaAlloc(parser->arena, sizeof(NOT_BUFFERED " ...") + length);
+        if (code == NULL) return "";
+        memcpy(code, NOT_BUFFERED " ...", sizeof(NOT_BUFFERED " ...") - 1);
+        memcpy(code + sizeof(NOT_BUFFERED " ...") - 1, rest, length + 1);
+        return code;
+    }
+    return copyErrorText(parser, text + (start - first), (size_t)(end - start));
+}
+
+void advance(Parser* parser) {
+    if (parser->current_token != NULL) {
+        parser->current_token = fetchToken(parser);
+    }
+}
+
+bool match(Parser* parser, TokenKind kind) {
+    if (check(parser, kind)) {
+        advance(parser);
+        return true;
+    }
+    return false;
+}
+
+bool matchType(Parser* parser, TokenType type) {
+    if (checkType(parser, type)) {
+        advance(parser);
+        return true;
+    }
+    return false;
+}
+
+bool check(Parser* parser, TokenKind kind) {
+    if (parser->current_token == NULL) return false;
+    return parser->current_token->kind == kind;
+}
+
+bool checkType(Parser* parser, TokenType type) {
+    if (parser->current_token == NULL) return false;
+    return parser->current_token->type == type;
+}
+
+void recordError(Parser* parser, const char* message) {
+    if (parser->error_count >= MAX_ERRORS) return;
+    
+    ErrorInfo* error = &parser->errors[parser->error_count];
+    error->message = message;
+    if (parser->current_token != NULL) {
+        int length;
+        const char* text = tokenText(parser, parser->current_token, &length);
+        size_t line = parser->lines != NULL ? findLine(parser->lines, parser->current_token->start) : 0;
+        if (parser->lines != NULL && line < parser->lines->count) {
+            error->line = (long long)(parser->lines->first_line + line);
+            error->column = (long long)findColumn(parser->source_text, parser->lines, line,
+                                                  parser->current_token->start);
+        } else {
+            error->line = -1;
+            error->column = -1;
+        }
+        error->found = parser->current_token->start < parser->source_text->offset ?
+                       NOT_BUFFERED : copyErrorText(parser, text, (size_t)length);
+        error->code = copySourceLine(parser, parser->current_token);
+    } else {
+        error->line = -1;
+        error->column = -1;
+        error->found = "end of file";
+        error->code = "";
+    }
+    parser->error_count++;
+}
+
+// Panic mode recovery: skip to semicolon. Loaded tokens jump straight there;
+// tokens pulled from the lexer are stepped over one by one.
+void skipToSemicolon(Parser* parser) {
+    if (parser->current_token != NULL && loadRecoveryIndex(parser)) {
+        const RecoveryIndex* index = &parser->recovery;
+        jumpToToken(parser, nextTokenBit(index->stops, index->words, parser->token_array.next - 1, index->end));
+    }
+    while (parser->current_token != NULL && !check(parser, TK_SEMICOLON)) {
+        // Also stop at closing brace to avoid skipping too much
+        if (check(parser, TK_RBRACE)) {
+            return;
+        }
+        advance(parser);
+    }
+    if (check(parser, TK_SEMICOLON)) {
+        advance(parser); // consume the semicolon
+    }
+}
+
+// Panic mode recovery: skip to closing brace. Loaded tokens jump straight
+// there; tokens pulled from the lexer are stepped over one by one.
+void skipToCloseBrace(Parser* parser) {
+    int brace_count = 1;
+    if (parser->current_token != NULL && loadRecoveryIndex(parser)) {
+        const RecoveryIndex* index = &parser->recovery;
+        size_t brace = nextTokenBit(index->braces, index->words, parser->token_array.next - 1, index->end);
+        if (brace < index->end) {
+            brace = index->brace_token[index->brace_close[braceRank(index, brace)]];
+        }
+        jumpToToken(parser, brace);
+    }
+    while (parser->current_token != NULL && brace_count > 0) {
+        if (check(parser, TK_LBRACE)) {
+            brace_count++;
+        } else if (check(parser, TK_RBRACE)) {
+            brace_count--;
+            if (brace_count == 0) {
+                return; // Don't consume the closing brace
+            }
+        }
+        advance(parser);
+    }
+}
+
+#ifndef _WIN32
+enum { CHUNK_PENDING, CHUNK_RUNNING, CHUNK_DONE, CHUNK_SKIPPED };
+
+// A run of statements at the top level of a large block, from just after one
+// of its ';' to the first statement at or past stop. It is parsed ahead on
+// another thread exactly as the block's statement loop would parse it on
+// reaching start, so if the loop does reach start its trace and errors are
+// used instead, and the loop goes on from resume.
+typedef struct ParseChunk {
+    uint32_t start;
+    uint32_t stop;            // the next chunk's start or the block's '}'
+    uint32_t resume;          // the token the loop goes on from, or the token count
+    int state;                // CHUNK_*, under the plan's lock
+    char* output;             // trace, from open_memstream
+    size_t output_length;
+    ErrorInfo* errors;        // in the arena of the thread that parsed it, texts too
+    int error_count;
+    size_t peak;              // its parser's stack.peak: frames above the block's
+} ParseChunk;
+
+// Chunks a worker still has to parse: [head, tail) of the plan. The owner
+// takes from the head, the chunk the parse will reach first, and thieves
+// from the tail.
+typedef struct ChunkQueue {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+} ChunkQueue;
+
+typedef struct ParseWorker {
+    ParsePlan* plan;
+    int id;
+    pthread_t thread;
+    bool started;
+    ChunkQueue queue;
+    Arena arena;              // error texts of its chunks; outlives the parse
+} ParseWorker;
+
+struct ParsePlan {
+    const Parser* parent;     // what each chunk's parser reads tokens and lines from
+    ParseChunk* chunks;       // in token order
+    size_t count;
+    size_t capacity;
+    uint64_t* starts;         // bit i % 64 of word i / 64: a chunk starts at token i
+    ParseWorker* workers;
+    int worker_count;
+    pthread_mutex_t lock;     // guards the chunk states
+    pthread_cond_t finished;  // some chunk is done
+};
+
+static void addChunk(ParsePlan* plan, size_t start, size_t stop) {
+    if (plan->count == plan->capacity) {
+        size_t capacity = plan->capacity ? plan->capacity * 2 : 64;
+        ParseChunk* grown = (ParseChunk*)realloc(plan->chunks, capacity * sizeof(ParseChunk));
+        if (!grown) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        plan->chunks = grown;
+        plan->capacity = capacity;
+    }
+    ParseChunk* chunk = &plan->chunks[plan->count++];
+    memset(chunk, 0, sizeof(*chunk));
+    chunk->start = (uint32_t)start;
+    chunk->stop = (uint32_t)stop;
+    chunk->state = CHUNK_PENDING;
+}
+
+// Cut the block from the '{' at open to the '}' at close into chunks of about
+// PARALLEL_PARSE_CHUNK tokens, each starting just after a ';' of the block
+// itself. Nested blocks are stepped over whole with the recovery index.
+static void planBlock(ParsePlan* plan, const RecoveryIndex* index, size_t open, size_t close) {
+    size_t p = open + 1;
+    size_t first = plan->count;
+    
+    for (;;) {
+        size_t target = p + PARALLEL_PARSE_CHUNK;
+        if (target >= close) break;
+        while (p < target) {
+            size_t brace = nextTokenBit(index->braces, index->words, p, index->end);
+            if (brace >= target) {
+                p = target;
+            } else {
+                p = brace == close ? close : matchingBrace(index, brace) + 1;
+            }
+        }
+        // The next ';' of the block: one with no brace before it
+        while (p < close) {
+            size_t stop = nextTokenBit(index->stops, index->words, p, index->end);
+            size_t brace = nextTokenBit(index->braces, index->words, p, index->end);
+            if (brace <= stop) {
+                p = brace == close ? close : matchingBrace(index, brace) + 1;
+                continue;
+            }
+            p = stop + 1;
+            break;
+        }
+        if (p >= close) break;
+        if (plan->count > first) {
+            plan->chunks[plan->count - 1].stop = (uint32_t)p;
+        }
+        addChunk(plan, p, close);
+    }
+}
+
+static int compareChunks(const void* a, const void* b) {
+    uint32_t x = ((const ParseChunk*)a)->start, y = ((const ParseChunk*)b)->start;
+    return x < y ? -1 : x > y;
+}
+
+static void finishChunk(ParsePlan* plan, ParseChunk* chunk, int state) {
+    pthread_mutex_lock(&plan->lock);
+    chunk->state = state;
+    pthread_cond_broadcast(&plan->finished);
+    pthread_mutex_unlock(&plan->lock);
+}
+
+// Parse a chunk with a parser of its own that reads the parent's tokens. A
+// chunk that runs out of memory is skipped, and the parse does it itself.
+static void parseChunk(ParsePlan* plan, ParseChunk* chunk, Arena* arena) {
+    const Parser* parent = plan->parent;
+    Parser parser;
+    
+    initParser(&parser, arena);
+    parser.token_array.tokens = parent->token_array.tokens;
+    parser.token_array.count = parent->token_array.count;
+    parser.token_array.next = chunk->start;
+    parser.token_source = nextArrayToken;
+    parser.token_source_context = &parser.token_array;
+    parser.source_text = parent->source_text;
+    parser.lines = parent->lines;
+    parser.tokens_counted = true;
+    parser.recovery = parent->recovery;
+    parser.plan = plan;
+    parser.max_depth = parent->max_depth;
+    parser.output = open_memstream(&chunk->output, &chunk->output_length);
+    if (parser.output == NULL) {
+        chunk->output = NULL;
+        finishChunk(plan, chunk, CHUNK_SKIPPED);   // the parse does it itself
+        return;
+    }
+    
+    // The first statement is the chunk's own, which must not be spliced
+    parser.current_token = fetchToken(&parser);
+    if (parser.current_token != NULL && !check(&parser, TK_RBRACE)) {
+        parseBlockStatement(&parser);
+    }
+    while (parser.current_token != NULL && !check(&parser, TK_RBRACE) &&
+           parser.token_array.next - 1 < chunk->stop) {
+        if (!spliceChunk(&parser)) {
+            parseBlockStatement(&parser);
+        }
+    }
+    chunk->resume = (uint32_t)(parser.current_token != NULL ? parser.token_array.next - 1 : parser.token_array.count);
+    fclose(parser.output);
+    chunk->errors = (ErrorInfo*)arenaAlloc(arena, (size_t)parser.error_count * sizeof(ErrorInfo));
+    if (chunk->errors != NULL) {
+        memcpy(chunk->errors, parser.errors, (size_t)parser.error_count * sizeof(ErrorInfo));
+    }
+    chunk->error_count = parser.error_count;
+    chunk->peak = parser.stack.peak;
+    freeParseStack(&parser);
+    
+    // Error texts the arena had no room for would be lost
+    finishChunk(plan, chunk, arena->failed ? CHUNK_SKIPPED : CHUNK_DONE);
+}
+
+static bool takeChunk(ParseWorker* worker, size_t* index) {
+    ParsePlan* plan = worker->plan;
+    
+    pthread_mutex_lock(&worker->queue.lock);
+    if (worker->queue.head < worker->queue.tail) {
+        *index = worker->queue.head++;
+        pthread_mutex_unlock(&worker->queue.lock);
+        return true;
+    }
+    pthread_mutex_unlock(&worker->queue.lock);
+    
+    // Own queue is empty: steal the last chunk of the next busy worker
+    for (int n = 1; n < plan->worker_count; n++) {
+        ChunkQueue* victim = &plan->workers[(worker->id + n) % plan->worker_count].queue;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->head < victim->tail) {
+            *index = --victim->tail;
+            pthread_mutex_unlock(&victim->lock);
+            return true;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return false;
+}
+
+static void* parseWorker(void* argument) {
+    ParseWorker* worker = (ParseWorker*)argument;
+    ParsePlan* plan = worker->plan;
+    size_t index;
+    
+    while (takeChunk(worker, &index)) {
+        ParseChunk* chunk = &plan->chunks[index];
+        bool claimed;
+        pthread_mutex_lock(&plan->lock);
+        claimed = chunk->state == CHUNK_PENDING;
+        if (claimed) {
+            chunk->state = CHUNK_RUNNING;
+        }
+        pthread_mutex_unlock(&plan->lock);
+        if (claimed) {
+            parseChunk(plan, chunk, &worker->arena);
+        }
+    }
+    return NULL;
+}
+
+// Plan chunks for every block of the loaded tokens that spans at least two
+// of them, and start threads - 1 workers on them; this thread goes on with
+// the parse itself. Needs the whole token array, so a parse pulling from a
+// lexer stays on one thread.
+void startParallelParse(Parser* parser, int threads) {
+    parser->plan = NULL;
+    if (threads <= 1 || parser->current_token == NULL || !loadRecoveryIndex(parser)) return;
+    
+    const RecoveryIndex* index = &parser->recovery;
+    ParsePlan* plan = (ParsePlan*)calloc(1, sizeof(ParsePlan));
+    if (!plan) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    plan->parent = parser;
+    for (size_t k = 0; k < index->brace_count; k++) {
+        size_t open = index->brace_token[k];
+        size_t close;
+        if ((index->stops[open / 64] >> (open % 64)) & 1) continue;   // a '}'
+        close = matchingBrace(index, open);
+        if (close < index->end && close - open >= 2 * PARALLEL_PARSE_CHUNK) {
+            planBlock(plan, index, open, close);
+        }
+    }
+    if (plan->count == 0) {
+        free(plan);
+        return;
+    }
+    qsort(plan->chunks, plan->count, sizeof(ParseChunk), compareChunks);
+    plan->starts = (uint64_t*)calloc(index->words, sizeof(uint64_t));
+    plan->worker_count = threads - 1;
+    plan->workers = (ParseWorker*)calloc((size_t)plan->worker_count, sizeof(ParseWorker));
+    if (!plan->starts || !plan->workers) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < plan->count; i++) {
+        plan->starts[plan->chunks[i].start / 64] |= (uint64_t)1 << (plan->chunks[i].start % 64);
+    }
+    pthread_mutex_init(&plan->lock, NULL);
+    pthread_cond_init(&plan->finished, NULL);
+    parser->plan = plan;
+    
+    // Each worker starts with an equal run of the chunks
+    for (int i = 0; i < plan->worker_count; i++) {
+        ParseWorker* worker = &plan->workers[i];
+        worker->plan = plan;
+        worker->id = i;
+        worker->queue.head = plan->count * (size_t)i / (size_t)plan->worker_count;
+        worker->queue.tail = plan->count * (size_t)(i + 1) / (size_t)plan->worker_count;
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        initArena(&worker->arena);
+    }
+    for (int i = 0; i < plan->worker_count; i++) {
+        ParseWorker* worker = &plan->workers[i];
+        worker->started = pthread_create(&worker->thread, NULL, parseWorker, worker) == 0;
+    }
+}
+
+// Stop the workers once the parse is over; chunks not yet started are dropped
+void finishParallelParse(Parser* parser) {
+    ParsePlan* plan = parser->plan;
+    if (plan == NULL) return;
+    
+    pthread_mutex_lock(&plan->lock);
+    for (size_t i = 0; i < plan->count; i++) {
+        if (plan->chunks[i].state == CHUNK_PENDING) {
+            plan->chunks[i].state = CHUNK_SKIPPED;
+        }
+    }
+    pthread_mutex_unlock(&plan->lock);
+    for (int i = 0; i < plan->worker_count; i++) {
+        if (plan->workers[i].started) {
+            pthread_join(plan->workers[i].thread, NULL);
+        }
+    }
+    for (int i = 0; i < plan->worker_count; i++) {
+        pthread_mutex_destroy(&plan->workers[i].queue.lock);
+        freeArena(&plan->workers[i].arena);
+    }
+    for (size_t i = 0; i < plan->count; i++) {
+        free(plan->chunks[i].output);
+    }
+    pthread_mutex_destroy(&plan->lock);
+    pthread_cond_destroy(&plan->finished);
+    free(plan->workers);
+    free(plan->starts);
+    free(plan->chunks);
+    free(plan);
+    parser->plan = NULL;
+}
+
+// At the top of a block's statement loop: if a chunk starts at the current
+// token, copy its trace and errors and jump to where it stopped, waiting for
+// it if another thread is parsing it. A chunk nobody has started, or one
+// that would nest past max_depth from here, is parsed here in the ordinary
+// way instead.
+bool spliceChunk(Parser* parser) {
+    ParsePlan* plan = parser->plan;
+    if (plan == NULL) return false;
+    
+    size_t at = parser->token_array.next - 1;
+    if (!((plan->starts[at / 64] >> (at % 64)) & 1)) return false;
+    
+    size_t low = 0, high = plan->count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (plan->chunks[mid].start <= at) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    ParseChunk* chunk = &plan->chunks[low];
+    
+    pthread_mutex_lock(&plan->lock);
+    if (chunk->state == CHUNK_PENDING) {
+        chunk->state = CHUNK_SKIPPED;
+    }
+    while (chunk->state == CHUNK_RUNNING) {
+        pthread_cond_wait(&plan->finished, &plan->lock);
+    }
+    bool done = chunk->state == CHUNK_DONE;
+    pthread_mutex_unlock(&plan->lock);
+    
+    // Its parse started with an empty stack; here it would have been deeper
+    if (!done || parser->stack.depth + chunk->peak > parser->max_depth) return false;
+    if (parser->stack.depth + chunk->peak > parser->stack.peak) {
+        parser->stack.peak = parser->stack.depth + chunk->peak;
+    }
+    
+    fwrite(chunk->output, 1, chunk->output_length, parser->output);
+    for (int i = 0; i < chunk->error_count && parser->error_count < MAX_ERRORS; i++) {
+        ErrorInfo* error = &parser->errors[parser->error_count++];
+        *error = chunk->errors[i];
+        error->found = copyErrorText(parser, error->found, strlen(error->found));
+        error->code = copyErrorText(parser, error->code, strlen(error->code));
+    }
+    jumpToToken(parser, chunk->resume);
+    return true;
+}
+#else
+void startParallelParse(Parser* parser, int threads) {
+    (void)threads;
+    parser->plan = NULL;
+}
+
+void finishParallelParse(Parser* parser) {
+    (void)parser;
+}
+
+bool spliceChunk(Parser* parser) {
+    (void)parser;
+    return false;
+}
+#endif
+
+bool isDataType(Parser* parser) {
+    if (parser->current_token == NULL) return false;
+    return (token_kind_flags[parser->current_token->kind] & KF_DATA_TYPE) != 0;
+}
+
+bool isScopeModifier(Parser* parser) {
+    if (parser->current_token == NULL) return false;
+    return (token_kind_flags[parser->current_token->kind] & KF_SCOPE) != 0;
+}
+
+// The grammar runs on parser->stack instead of the C stack, so code may nest
+// as deep as parser->max_depth allows without overflowing the thread's
+// stack. Each open construct is a frame whose state says what is left of it
+// once the statement, block or expression nested in it has been parsed.
+enum {
+    PS_STATEMENT,      // a statement, not yet begun
+    PS_BODY,           // the body of an if or a loop: a block or one statement
+    PS_BLOCK,          // a block's statement loop
+    PS_BLOCK_NEXT,     // a block's statement was parsed: skip the token if stuck on it
+    PS_THEN,           // a 'do if' body was parsed: 'then do' and its body may follow
+    PS_CASES,          // the 'what if' cases of a compare
+    PS_CASE_BODY,      // the statements of one case
+    PS_DEFAULT_BODY,   // the statements after 'then do:' in a compare
+    PS_OPERAND,        // the right operand of an operator, or the operand after unary ones
+    PS_PAREN           // an expression after '('
+};
+
+// Push a frame, or report the code at the current token as nested too deeply.
+// If the stack cannot grow the code is skipped the same way, and the
+// parser's arena records the failure for the driver.
+bool pushFrame(Parser* parser, int state) {
+    ParseStack* stack = &parser->stack;
+    if (stack->depth >= parser->max_depth) {
+        stack->peak = parser->max_depth + 1;
+        recordError(parser, "Code is nested too deeply here; the nested part was skipped");
+        return false;
+    }
+    if (stack->depth == stack->capacity) {
+        size_t capacity = stack->capacity > 0 ? stack->capacity * 2 : 64;
+        ParseFrame* frames = (ParseFrame*)realloc(stack->frames, capacity * sizeof(ParseFrame));
+        if (frames == NULL) {
+            parser->arena->failed = true;
+            return false;
+        }
+        stack->frames = frames;
+        stack->capacity = capacity;
+    }
+    stack->frames[stack->depth].state = state;
+    stack->frames[stack->depth].before = parser->current_index;
+    stack->depth++;
+    if (stack->depth > stack->peak) {
+        stack->peak = stack->depth;
+    }
+    return true;
+}
+
+void freeParseStack(Parser* parser) {
+    free(parser->stack.frames);
+    memset(&parser->stack, 0, sizeof(parser->stack));
+}
+
+// Skip the statement or block at the current token without parsing it: up
+// to and including the first ';' outside brackets, or the '}' closing its
+// first '{' unless 'then' follows. A '}' that closes an enclosing block is
+// left alone. Each block is passed over whole by skipToCloseBrace, so
+// loaded tokens jump to its '}'.
+void skipNested(Parser* parser) {
+    size_t parens = 0;
+    while (parser->current_token != NULL) {
+        if (check(parser, TK_LBRACE)) {
+            advance(parser);
+            skipToCloseBrace(parser);
+            if (!match(parser, TK_RBRACE) || !check(parser, TK_THEN)) return;
+            continue;
+        } else if (check(parser, TK_RBRACE)) {
+            return;
+        } else if (check(parser, TK_LPAREN)) {
+            parens++;
+        } else if (check(parser, TK_RPAREN)) {
+            if (parens > 0) parens--;
+        } else if (check(parser, TK_SEMICOLON) && parens == 0) {
+            advance(parser);
+            return;
+        }
+        advance(parser);
+    }
+}
+
+// Skip the rest of an expression after a '(' nested too deeply, up to and
+// including its ')', or up to the end of the statement
+void skipParenthesized(Parser* parser) {
+    size_t parens = 1;
+    while (parser->current_token != NULL && !check(parser, TK_SEMICOLON) &&
+           !check(parser, TK_LBRACE) && !check(parser, TK_RBRACE)) {
+        if (check(parser, TK_LPAREN)) {
+            parens++;
+        } else if (check(parser, TK_RPAREN) && --parens == 0) {
+            advance(parser);
+            return;
+        }
+        advance(parser);
+    }
+}
+
+// Skip the rest of an expression nested too deeply: up to the end of the
+// statement, a ',' or an unmatched ')'
+void skipExpression(Parser* parser) {
+    size_t parens = 0;
+    while (parser->current_token != NULL && !check(parser, TK_SEMICOLON) &&
+           !check(parser, TK_LBRACE) && !check(parser, TK_RBRACE)) {
+        if (check(parser, TK_LPAREN)) {
+            parens++;
+        } else if (check(parser, TK_RPAREN)) {
+            if (parens == 0) return;
+            parens--;
+        } else if (check(parser, TK_COMMA) && parens == 0) {
+            return;
+        }
+        advance(parser);
+    }
+}
+
+// A nested statement: one more frame, or the statement skipped
+void pushStatement(Parser* parser) {
+    if (!pushFrame(parser, PS_STATEMENT)) {
+        skipNested(parser);
+    }
+}
+
+// The body of an if or a loop: a block or one statement
+void pushBody(Parser* parser) {
+    if (!pushFrame(parser, PS_BODY)) {
+        skipNested(parser);
+    }
+}
+
+// If the statement begun at token before consumed nothing, skip the token
+// to prevent an infinite loop
+void skipStuckToken(Parser* parser, size_t before) {
+    if (parser->current_index == before && parser->current_token != NULL) {
+        int length;
+        const char* text = tokenText(parser, parser->current_token, &length);
+        fprintf(parser->output, "  Warning: Skipping stuck token '%.*s'\n", length, text);
+        advance(parser);
+    }
+}
+
+void openBlock(Parser* parser) {
+    fprintf(parser->output, "  Parsing BLOCK...\n");
+    
+    if (!match(parser, TK_LBRACE)) {
+        recordError(parser, "Missing '{' to start a block");
+        // Try to continue parsing statements
+    }
+}
+
+void closeBlock(Parser* parser) {
+    if (!match(parser, TK_RBRACE)) {
+        recordError(parser, "Missing '}' to close a block");
+    } else {
+        fprintf(parser->output, "  BLOCK closed properly.\n");
+    }
+    
+    fprintf(parser->output, "  BLOCK parsing done.\n");
+}
+
+// Run the frames above base until they are all closed
+void runStatements(Parser* parser, size_t base) {
+    while (parser->stack.depth > base) {
+        ParseFrame* frame = &parser->stack.frames[parser->stack.depth - 1];
+        switch (frame->state) {
+            case PS_BODY:
+                if (check(parser, TK_LBRACE)) {
+                    frame->state = PS_BLOCK;
+                    openBlock(parser);
+                    break;
+                }
+                // fall through
+            case PS_STATEMENT:
+                // The statement's frame is free for whatever is nested in it
+                parser->stack.depth--;
+                beginStatement(parser);
+                break;
+            case PS_BLOCK:
+                if (parser->current_token == NULL || check(parser, TK_RBRACE)) {
+                    parser->stack.depth--;
+                    closeBlock(parser);
+                } else if (!spliceChunk(parser)) {
+                    frame->state = PS_BLOCK_NEXT;
+                    frame->before = parser->current_index;
+                    pushStatement(parser);
+                }
+                break;
+            case PS_BLOCK_NEXT:
+                frame->state = PS_BLOCK;
+                skipStuckToken(parser, frame->before);
+                break;
+            case PS_THEN:
+                // BLOCK 2: 'then do', The "Else" Substitute
+                if (!match(parser, TK_THEN)) {
+                    parser->stack.depth--;
+                } else if (!match(parser, TK_DO)) {
+                    // We found 'then', now we MUST find 'do'
+                    parser->stack.depth--;
+                    recordError(parser, "Missing 'do' after 'then'");
+                } else {
+                    // Parse the Else Body
+                    frame->state = PS_BODY;
+                }
+                break;
+            case PS_CASES:
+                if (match(parser, TK_WHAT)) {
+                    if (!match(parser, TK_IF)) {
+                        recordError(parser, "Missing 'if' after 'what'");
+                        break;
+                    }
+                    frame->state = PS_CASE_BODY;
+                    parseExpr(parser);
+                    if (!match(parser, TK_COLON)) {
+                        recordError(parser, "Missing ':' after case value");
+                    }
+                } else if (match(parser, TK_THEN)) {
+                    frame->state = PS_DEFAULT_BODY;
+                    if (!match(parser, TK_DO)) {
+                        recordError(parser, "Missing 'do' after 'then'");
+                    }
+                    if (!match(parser, TK_COLON)) {
+                        recordError(parser, "Missing ':' after 'then do'");
+                    }
+                } else {
+                    parser->stack.depth--;
+                    if (!match(parser, TK_RBRACE)) {
+                        recordError(parser, "Missing '}' at end of compare");
+                    }
+                }
+                break;
+            case PS_CASE_BODY:
+                if (parser->current_token != NULL && !check(parser, TK_BREAK) &&
+                    !check(parser, TK_WHAT) && !check(parser, TK_THEN) &&
+                    !check(parser, TK_RBRACE)) {
+                    pushStatement(parser);
+                    break;
+                }
+                frame->state = PS_CASES;
+                if (!match(parser, TK_BREAK)) {
+                    recordError(parser, "Missing 'break' at end of case");
+                }
+                if (!match(parser, TK_SEMICOLON)) {
+                    recordError(parser, "Missing ';' after 'break'");
+                }
+                break;
+            case PS_DEFAULT_BODY:
+                if (parser->current_token != NULL && !check(parser, TK_RBRACE)) {
+                    pushStatement(parser);
+                    break;
+                }
+                parser->stack.depth--;
+                if (!match(parser, TK_RBRACE)) {
+                    recordError(parser, "Missing '}' at end of compare");
+                }
+                break;
+            default:
+                // PS_OPERAND and PS_PAREN belong to parseExpr(), which closes its own
+                return;
+        }
+    }
+}
+
+void parseProgram(Parser* parser) {
+    fprintf(parser->output, "Parsing PROGRAM...\n");
+    
+    // Check for 'func' keyword (optional)
+    match(parser, TK_FUNC);
+    
+    // 'main' keyword
+    if (!match(parser, TK_MAIN)) {
+        recordError(parser, "Missing 'main' at the start of your program");
+        // Try to recover by looking for ':'
+        while (parser->current_token != NULL && !check(parser, TK_COLON)) {
+            advance(parser);
+        }
+    }
+    
+    if (!match(parser, TK_COLON)) {
+        recordError(parser, "Missing ':' after 'main'");
+        // Continue anyway to find more errors
+    }
+    
+    // Check if there's a block with braces or just statements
+    if (check(parser, TK_LBRACE)) {
+        // Traditional block with braces
+        parseBlock(parser);
+    } else {
+        // No braces - parse all statements until end of file
+        fprintf(parser->output, "  Parsing statements without block braces...\n");
+        while (parser->current_token != NULL) {
+            parseBlockStatement(parser);
+        }
+        fprintf(parser->output, "  All statements parsed.\n");
+    }
+    
+    fprintf(parser->output, "PROGRAM parsing done.\n");
+}
+
+void parseBlock(Parser* parser) {
+    size_t base = parser->stack.depth;
+    if (pushFrame(parser, PS_BLOCK)) {
+        openBlock(parser);
+        runStatements(parser, base);
+    } else {
+        skipNested(parser);
+    }
+}
+
+// One turn of a block's statement loop. It depends on nothing but the tokens
+// from the current one on, which is what lets a piece of a block be parsed
+// ahead on another thread.
+void parseBlockStatement(Parser* parser) {
+    size_t before = parser->current_index;
+    parseStatement(parser);
+    skipStuckToken(parser, before);
+}
+
+void parseStatement(Parser* parser) {
+    size_t base = parser->stack.depth;
+    if (pushFrame(parser, PS_STATEMENT)) {
+        runStatements(parser, base);
+    } else {
+        skipNested(parser);
+    }
+}
+
+// Parse a statement up to the first statement or block nested in it, if
+// any, leaving frames for the rest; the statement's own frame has already
+// been popped
+void beginStatement(Parser* parser) {
+    if (parser->current_token == NULL) {
+        recordError(parser, "Unexpected end of code");
+        return;
+    }
+    
+    // Declaration statement
+    if (isScopeModifier(parser) || isDataType(parser) || check(parser, TK_CONS)) {
+        parseDecStmt(parser);
+    }
+    // Conditional statement
+    else if (check(parser, TK_DO) || check(parser, TK_COMPARE) || 
+             check(parser, TK_IF)) {
+        parseConditionalStmt(parser);
+    }
+    // Iterative statement
+    else if (check(parser, TK_CONTINUE) || check(parser, TK_STOP)) {
+        parseIterativeStmt(parser);
+    }
+    // Output statement
+    else if (check(parser, TK_DISPLAY)) {
+        parseOutputStmt(parser);
+    }
+    // Input statement
+    else if (check(parser, TK_PUT)) {
+        parseInputStmt(parser);
+    }
+    // Break statement
+    else if (check(parser, TK_BREAK) || check(parser, TK_BACK)) {
+        parseBreakStmt(parser);
+    }
+    // Assignment statement
+    else if (checkType(parser, IDENTIFIER)) {
+        parseAssStmt(parser);
+    }
+    else {
+        recordError(parser, "This doesn't look like a valid statement");
+        skipToSemicolon(parser); // Recovery: skip to next statement
+    }
+}
+
+void parseDecStmt(Parser* parser) {
+    // Check for 'cons' (constant)
+    if (match(parser, TK_CONS)) {
+        if (!isDataType(parser)) {
+            recordError(parser, "Missing data type after 'cons' (like int, float, text)");
+            skipToSemicolon(parser);
+            return;
+        }
+        advance(parser);
+        
+        if (!matchType(parser, IDENTIFIER)) {
+            recordError(parser, "Missing variable name after data type");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        if (!match(parser, TK_ASSIGN)) {
+            recordError(parser, "Constant needs '=' and a value");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        parseExpr(parser);
+        
+        if (!match(parser, TK_SEMICOLON)) {
+            recordError(parser, "Missing ';' at the end of this line");
+            skipToSemicolon(parser);
+        }
+        return;
+    }
+    
+    // Optional scope modifier
+    if (isScopeModifier(parser)) {
+        advance(parser);
+    }
+    
+    // Data type (required)
+    if (!isDataType(parser)) {
+        recordError(parser, "Missing data type (like int, float, text)");
+        skipToSemicolon(parser);
+        return;
+    }
+    advance(parser);
+    
+    if (!matchType(parser, IDENTIFIER)) {
+        recordError(parser, "Missing variable name");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    // Check what comes next
+    if (match(parser, TK_ASSIGN)) {
+        parseExpr(parser);
+        
+        while (match(parser, TK_COMMA)) {
+            if (!matchType(parser, IDENTIFIER)) {
+                recordError(parser, "Missing variable name after ','");
+                skipToSemicolon(parser);
+                return;
+            }
+            if (match(parser, TK_ASSIGN)) {
+                parseExpr(parser);
+            }
+        }
+        
+        if (!match(parser, TK_SEMICOLON)) {
+            recordError(parser, "Missing ';' at the end of this line");
+            skipToSemicolon(parser);
+        }
+    }
+    else if (match(parser, TK_COMMA)) {
+        parseIdList(parser);
+        if (!match(parser, TK_SEMICOLON)) {
+            recordError(parser, "Missing ';' at the end of this line");
+            skipToSemicolon(parser);
+        }
+    }
+    else if (match(parser, TK_SEMICOLON)) {
+        // Simple declaration is fine
+    }
+    else {
+        recordError(parser, "Expected ';', '=', or ',' after variable name");
+        skipToSemicolon(parser);
+    }
+}
+
+void parseIdList(Parser* parser) {
+    if (!matchType(parser, IDENTIFIER)) {
+        recordError(parser, "Missing variable name in the list");
+        return;
+    }
+    
+    if (match(parser, TK_ASSIGN)) {
+        parseExpr(parser);
+    }
+    
+    while (match(parser, TK_COMMA)) {
+        if (!matchType(parser, IDENTIFIER)) {
+            recordError(parser, "Missing variable name after ','");
+            return;
+        }
+        if (match(parser, TK_ASSIGN)) {
+            parseExpr(parser);
+        }
+    }
+}
+
+void parseAssStmt(Parser* parser) {
+    if (!matchType(parser, IDENTIFIER)) {
+        recordError(parser, "Missing variable name");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    // Check for assignment operators
+    if (parser->current_token == NULL || !(token_kind_flags[parser->current_token->kind] & KF_ASSIGNMENT)) {
+        recordError(parser, "Missing '=' for assignment");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    // Consume the assignment operator
+    advance(parser);
+    
+    parseExpr(parser);
+    
+    if (!match(parser, TK_SEMICOLON)) {
+        recordError(parser, "Missing ';' at the end of this line");
+        skipToSemicolon(parser);
+    }
+}
+
+void parseConditionalStmt(Parser* parser) {
+
+    // BLOCK 1: 'do if' (The Conditional)
+    if (match(parser, TK_DO)) {
+        
+        // 1. Handle 'if' 
+        bool matched_if = match(parser, TK_IF);
+        
+        // If we found 'do' but NO 'if'
+        if (!matched_if) {
+            
+            recordError(parser, "Missing 'if' after 'do'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        // 2. Parse Condition: ( expr )
+        if (!match(parser, TK_LPAREN)) {
+            recordError(parser, "Missing '(' after 'if'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        parseExpr(parser);
+        
+        if (!match(parser, TK_RPAREN)) {
+            recordError(parser, "Missing ')' after condition");
+        }
+        
+        // 3. Parse Body: { block } or statement, then BLOCK 2 (PS_THEN)
+        pushFrame(parser, PS_THEN);
+        pushBody(parser);
+    }
+    
+    // BLOCK 3: 'compare' (Switch Case)
+    
+    else if (match(parser, TK_COMPARE)) {
+        parseExpr(parser);
+        
+        if (!match(parser, TK_LBRACE)) {
+            recordError(parser, "Missing '{' after compare");
+            return;
+        }
+        
+        // The cases, then the default, then '}' (PS_CASES)
+        pushFrame(parser, PS_CASES);
+    }
+    // Handle standalone 'if' without 'do'
+    else if (check(parser, TK_IF)) {
+        // This is 'if' without 'do', treat as error or allow it
+        recordError(parser, "Found 'if' without 'do' before it");
+        advance(parser);
+        
+        if (!match(parser, TK_LPAREN)) {
+            recordError(parser, "Missing '(' after 'if'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        parseExpr(parser);
+        
+        if (!match(parser, TK_RPAREN)) {
+            recordError(parser, "Missing ')' after condition");
+        }
+        
+        pushBody(parser);
+    }
+}
+
+void parseIterativeStmt(Parser* parser) {
+    if (match(parser, TK_CONTINUE)) {
+        if (!match(parser, TK_UNTIL)) {
+            recordError(parser, "Missing 'until' after 'continue'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        if (!match(parser, TK_LPAREN)) {
+            recordError(parser, "Missing '(' after 'until'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        parseExpr(parser);
+        
+        if (match(parser, TK_SEMICOLON)) {
+            parseExpr(parser);
+            
+            if (!match(parser, TK_SEMICOLON)) {
+                recordError(parser, "Missing ';' in loop");
+            }
+            
+            parseExpr(parser);
+        }
+        
+        if (!match(parser, TK_RPAREN)) {
+            recordError(parser, "Missing ')' after loop condition");
+        }
+        
+        pushBody(parser);
+    }
+    else if (match(parser, TK_STOP)) {
+        if (!match(parser, TK_WHEN)) {
+            recordError(parser, "Missing 'when' after 'stop'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        if (!match(parser, TK_LPAREN)) {
+            recordError(parser, "Missing '(' after 'when'");
+            skipToSemicolon(parser);
+            return;
+        }
+        
+        parseExpr(parser);
+        
+        if (!match(parser, TK_RPAREN)) {
+            recordError(parser, "Missing ')' after condition");
+        }
+        
+        pushBody(parser);
+    }
+}
+
+void parseOutputStmt(Parser* parser) {
+    if (!match(parser, TK_DISPLAY)) {
+        recordError(parser, "Missing 'display' keyword");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    parseExprList(parser);
+    
+    if (!match(parser, TK_SEMICOLON)) {
+        recordError(parser, "Missing ';' at the end of display");
+        skipToSemicolon(parser);
+    }
+}
+
+void parseInputStmt(Parser* parser) {
+    if (!match(parser, TK_PUT)) {
+        recordError(parser, "Missing 'put' keyword");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    if (!matchType(parser, IDENTIFIER)) {
+        recordError(parser, "Missing variable name after 'put'");
+        skipToSemicolon(parser);
+        return;
+    }
+    
+    if (!match(parser, TK_SEMICOLON)) {
+        recordError(parser, "Missing ';' at the end of put");
+        skipToSemicolon(parser);
+    }
+}
+
+void parseBreakStmt(Parser* parser) {
+    if (match(parser, TK_BREAK) || match(parser, TK_BACK)) {
+        if (!match(parser, TK_SEMICOLON)) {
+            recordError(parser, "Missing ';' after break/back");
+            skipToSemicolon(parser);
+        }
+    }
+}
+
+void parseExprList(Parser* parser) {
+    parseExpr(parser);
+    
+    while (match(parser, TK_COMMA)) {
+        parseExpr(parser);
+    }
+}
+
+// How tightly each binary operator holds its operands, by token kind; 0 for
+// tokens that are not one. A left-associative operator takes its right
+// operand at one more than its left power, so the next operator of its
+// level ends the operand; a right-associative one (assignments, '**') takes
+// it at the same power, so the next one nests inside.
+typedef struct BindingPower {
+    uint8_t left;
+    uint8_t right;
+} BindingPower;
+
+#define PREFIX_POWER 80   // unary + - ! ++ --: tighter than '*', looser than '**'
+
+static const BindingPower binding_powers[TK_COUNT] = {
+    [TK_ASSIGN] = {10, 10},
+    [TK_PLUS_ASSIGN] = {10, 10},
+    [TK_MINUS_ASSIGN] = {10, 10},
+    [TK_STAR_ASSIGN] = {10, 10},
+    [TK_SLASH_ASSIGN] = {10, 10},
+    [TK_PERCENT_ASSIGN] = {10, 10},
+    [TK_OR] = {20, 21},
+    [TK_AND] = {30, 31},
+    [TK_EQ] = {40, 41},
+    [TK_NE] = {40, 41},
+    [TK_LT] = {50, 51},
+    [TK_GT] = {50, 51},
+    [TK_LE] = {50, 51},
+    [TK_GE] = {50, 51},
+    [TK_PLUS] = {60, 61},
+    [TK_MINUS] = {60, 61},
+    [TK_STAR] = {70, 71},
+    [TK_SLASH] = {70, 71},
+    [TK_PERCENT] = {70, 71},
+    [TK_INT_DIV] = {70, 71},
+    [TK_POWER] = {90, 90},
+};
+
+static inline bool isPrefixOperator(TokenKind kind) {
+    return kind == TK_PLUS || kind == TK_MINUS || kind == TK_NOT || kind == TK_INC || kind == TK_DEC;
+}
+
+// Open a level of an expression, saving the binding power outside it. One
+// is opened per operator, so the common case is kept out of pushFrame().
+static inline bool pushExprLevel(Parser* parser, int state, int power) {
+    ParseStack* stack = &parser->stack;
+    if (stack->depth < stack->capacity && stack->depth < parser->max_depth) {
+        ParseFrame* frame = &stack->frames[stack->depth++];
+        frame->state = state;
+        frame->power = power;
+        if (stack->depth > stack->peak) {
+            stack->peak = stack->depth;
+        }
+        return true;
+    }
+    if (!pushFrame(parser, state)) return false;
+    stack->frames[stack->depth - 1].power = power;
+    return true;
+}
+
+// An expression, by precedence climbing over binding_powers. Each operator
+// taken opens a level for its right operand that lasts until an operator
+// that binds less tightly than it; each '(' opens one that lasts until its
+// ')'. Levels are frames on parser->stack rather than calls, so they nest
+// as deep as max_depth allows.
+void parseExpr(Parser* parser) {
+    size_t base = parser->stack.depth;
+    int power = 0;            // the least left power that continues the current level
+    
+    for (;;) {
+        bool assignable = false;   // the operand so far is a lone variable
+        bool prefixed = false;
+        
+        // Unary operators: a run of them is one level
+        while (parser->current_token != NULL && isPrefixOperator(parser->current_token->kind)) {
+            advance(parser);
+            prefixed = true;
+        }
+        bool skipped = false;
+        if (prefixed) {
+            if (pushExprLevel(parser, PS_OPERAND, power)) {
+                power = PREFIX_POWER;
+            } else {
+                skipExpression(parser);
+                skipped = true;
+            }
+        }
+        
+        if (skipped) {
+            // The operand went with the rest of the expression
+        } else if (match(parser, TK_LPAREN)) {
+            if (pushExprLevel(parser, PS_PAREN, power)) {
+                power = 0;
+                continue;
+            }
+            skipParenthesized(parser);
+        } else {
+            assignable = checkType(parser, IDENTIFIER) && !prefixed;
+            parsePrimaryExpr(parser);
+        }
+        
+        // Postfix operators, then either an operator that takes the operand
+        // so far as its left one, or the end of the current level
+        for (;;) {
+            while (match(parser, TK_INC) || match(parser, TK_DEC)) {
+                assignable = false;
+            }
+            const BindingPower* op = parser->current_token != NULL ? &binding_powers[parser->current_token->kind] : NULL;
+            if (op != NULL && op->left > 0 && op->left >= power) {
+                if ((token_kind_flags[parser->current_token->kind] & KF_ASSIGNMENT) && !assignable) {
+                    recordError(parser, "Only a variable can be assigned a value");
+                }
+                advance(parser);
+                if (pushExprLevel(parser, PS_OPERAND, power)) {
+                    power = op->right;
+                    break;
+                }
+                skipExpression(parser);
+                assignable = false;
+                continue;
+            }
+            if (parser->stack.depth == base) {
+                return;
+            }
+            ParseFrame* frame = &parser->stack.frames[--parser->stack.depth];
+            power = frame->power;
+            assignable = false;
+            if (frame->state == PS_PAREN && !match(parser, TK_RPAREN)) {
+                recordError(parser, "Missing ')' in expression");
+            }
+        }
+    }
+}
+
+// An operand other than a parenthesized expression
+void parsePrimaryExpr(Parser* parser) {
+    if (matchType(parser, IDENTIFIER)) {
+        return;
+    }
+    else if (matchType(parser, CONSTANT)) {
+        return;
+    }
+    else if (checkType(parser, RESERVED_WORDS)) {
+        advance(parser);
+        return;
+    }
+    else {
+        recordError(parser, "Invalid expression");
+        // Try to recover
+        advance(parser);
+    }
+}
+
+void echoPrintf(Parser* parser, const char* format, ...) {
+    va_list args;
+    if (parser->echo == NULL) return;
+    va_start(args, format);
+    vfprintf(parser->echo, format, args);
+    va_end(args);
+}
+
+void printTokenStatistics(Parser* parser) {
+    const char* names[] = {
+        "IDENTIFIER",
+        "OPERATION",
+        "KEYWORDS",
+        "RESERVED_WORDS",
+        "CONSTANT",
+        "NOISE_WORDS",
+        "COMMENT",
+        "WHITE_SPACE",
+        "DELIMITER"
+    };
+    fprintf(parser->output, "=== TOKEN STATISTICS ===\n");
+    echoPrintf(parser, "=== TOKEN STATISTICS ===\n");
+    int max = DELIMITER;
+    for (int i = 0; i <= max; i++) {
+        fprintf(parser->output, "  %s: %" PRIu64 "\n", names[i], parser->token_counts[i]);
+        echoPrintf(parser, "  %s: %" PRIu64 "\n", names[i], parser->token_counts[i]);
+    }
+    fprintf(parser->output, "  Total tokens: %" PRIu64 "\n", parser->total_tokens);
+    echoPrintf(parser, "  Total tokens: %" PRIu64 "\n", parser->total_tokens);
+    fprintf(parser->output, "  Distinct identifiers: %u\n\n", parser->name_count);
+    echoPrintf(parser, "  Distinct identifiers: %u\n\n", parser->name_count);
+}
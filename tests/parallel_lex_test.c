@@ -0,0 +1,201 @@
+// Regression test for the parallel lexer: every input is lexed once with
+// lexicalAnalyzer() and again with lexicalAnalyzerParallel() on 2 to 8
+// threads, and the tokens, the trivia and the identifier ids must match.
+//
+//     gcc -O2 -pthread -DLEXC_DRIVER -o parallel_lex_test tests/parallel_lex_test.c RevisedFinal.c
+//     ./parallel_lex_test [file.lxc ...]
+//
+// Without arguments the inputs are generated from a fixed seed, out of
+// fragments that put strings, comments, long words and line ends across
+// the points where the source is cut into slices. Exits with 1 on the first
+// difference.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lexer.h"
+
+#define MAX_THREADS 8
+
+static const char* const fragments[] = {
+    "main: {\n", "}\n", "let int x = 5, y, z = 3;\n", "x += 2 * (y - z) % 4;\n",
+    "y = x ** 2 // 3;\n", "display \"text\", x;\n", "do if (x > 0 && y <= 10 || !z) {\n",
+    "} then do {\n", "compare x {\n", "what if 1: display \"one\"; break;\n",
+    "## line comment with \"quote\" and *#\n", "#* block\n comment\n over lines *#",
+    "\"string\nacross lines\"", "\"## not a comment\"", "\"#* nor this *#\"",
+    "\t\t", "    ", "\r\n", "\n", "\n\n\n", " ", "identifier_with_a_rather_long_name_that_goes_past_the_lexeme_limit ",
+    "x1 y2 z3 ", "3.14 ", "12abc ", "@ $ ` ", "\xc3\xa9t\xc3\xa9 ", "[1, 2]; ", "a[0] = b;\n",
+    "goto timer index info gob; ", "true false cease exit system; ", "*# ", "# ", "#",
+};
+#define FRAGMENT_COUNT (sizeof(fragments) / sizeof(fragments[0]))
+
+static unsigned long long seed = 88172645463325252ull;
+
+static unsigned nextRandom(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned)(seed >> 32);
+}
+
+// Random fragments up to about size bytes, sometimes ending in an
+// unterminated string or comment
+static char* makeInput(size_t size, size_t* length) {
+    char* text = (char*)malloc(size + 128);
+    size_t used = 0;
+    if (!text) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    while (used < size) {
+        const char* fragment = fragments[nextRandom() % FRAGMENT_COUNT];
+        size_t n = strlen(fragment);
+        memcpy(text + used, fragment, n);
+        used += n;
+    }
+    switch (nextRandom() % 4) {
+        case 0:
+            memcpy(text + used, "\"open", 5);
+            used += 5;
+            break;
+        case 1:
+            memcpy(text + used, "#* open", 7);
+            used += 7;
+            break;
+        default:
+            break;
+    }
+    *length = used;
+    return text;
+}
+
+typedef struct LexResult {
+    TokenBuffer tokens;
+    TriviaBuffer trivia;
+    InternTable names;
+} LexResult;
+
+static void lexInput(const SourceBuffer* source, int threads, LexResult* result) {
+    initTokenBuffer(&result->tokens);
+    initTriviaBuffer(&result->trivia);
+    initInternTable(&result->names);
+    if (threads == 1) {
+        lexicalAnalyzer(source, &result->tokens, &result->trivia, &result->names);
+    } else {
+        lexicalAnalyzerParallel(source, &result->tokens, &result->trivia, &result->names, threads);
+    }
+}
+
+static void freeLexResult(LexResult* result) {
+    freeTokenBuffer(&result->tokens);
+    freeTriviaBuffer(&result->trivia);
+    freeInternTable(&result->names);
+}
+
+// Describes the first difference between expected and actual, or returns NULL
+static const char* compareResults(const LexResult* expected, const LexResult* actual, size_t* at) {
+    *at = 0;
+    if (expected->tokens.count != actual->tokens.count) {
+        return "token count";
+    }
+    for (size_t i = 0; i < expected->tokens.count; i++) {
+        const Token* a = &expected->tokens.tokens[i];
+        const Token* b = &actual->tokens.tokens[i];
+        *at = i;
+        if (a->start != b->start || a->length != b->length || a->kind != b->kind || a->type != b->type) {
+            return "token";
+        }
+        if (a->name_id != b->name_id) {
+            return "name id";
+        }
+    }
+    *at = 0;
+    if (expected->trivia.count != actual->trivia.count) {
+        return "trivia count";
+    }
+    for (size_t i = 0; i < expected->trivia.count; i++) {
+        const Trivia* a = &expected->trivia.trivia[i];
+        const Trivia* b = &actual->trivia.trivia[i];
+        *at = i;
+        if (a->start != b->start || a->length != b->length || a->kind != b->kind) {
+            return "trivia";
+        }
+    }
+    *at = 0;
+    if (expected->names.count != actual->names.count) {
+        return "name count";
+    }
+    for (uint32_t id = 1; id <= expected->names.count; id++) {
+        const InternName* a = internedName(&expected->names, id);
+        const InternName* b = internedName(&actual->names, id);
+        *at = id;
+        if (a->length != b->length || memcmp(a->text, b->text, a->length) != 0) {
+            return "name";
+        }
+    }
+    return NULL;
+}
+
+// Lexes source on 1 to MAX_THREADS threads; false after reporting a difference
+static bool checkInput(const SourceBuffer* source, const char* label) {
+    LexResult expected;
+    bool same = true;
+
+    lexInput(source, 1, &expected);
+    for (int threads = 2; threads <= MAX_THREADS && same; threads++) {
+        LexResult actual;
+        size_t at;
+        lexInput(source, threads, &actual);
+        const char* difference = compareResults(&expected, &actual, &at);
+        if (difference != NULL) {
+            printf("FAIL %s (%zu bytes), %d threads: %s differs at %zu\n",
+                   label, source->size, threads, difference, at);
+            same = false;
+        }
+        freeLexResult(&actual);
+    }
+    freeLexResult(&expected);
+    return same;
+}
+
+int main(int argc, char* argv[]) {
+    int inputs = 0;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            SourceBuffer source;
+            if (!loadSourceFile(argv[i], &source, 0)) {
+                printf("FAIL %s: cannot open the file\n", argv[i]);
+                return 1;
+            }
+            bool same = checkInput(&source, argv[i]);
+            releaseSourceFile(&source);
+            if (!same) {
+                return 1;
+            }
+            inputs++;
+        }
+    } else {
+        static const size_t sizes[] = { 0, 1, 7, 64, 300, 1000, 4096, 20000, 100000, 400000 };
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (int round = 0; round < (sizes[s] < 100000 ? 40 : 4); round++) {
+                char label[64];
+                SourceBuffer source;
+                size_t length;
+                char* text = makeInput(sizes[s], &length);
+                source.data = text;
+                source.size = length;
+                source.mapped = false;
+                snprintf(label, sizeof(label), "generated input %d", inputs + 1);
+                bool same = checkInput(&source, label);
+                free(text);
+                if (!same) {
+                    return 1;
+                }
+                inputs++;
+            }
+        }
+    }
+    printf("ok: %d inputs lexed alike on 1 to %d threads\n", inputs, MAX_THREADS);
+    return 0;
+}
@@ -0,0 +1,312 @@
+// Token types and token kinds shared by the lexer (RevisedFinal.c) and the
+// parser (syntax_analyzer2.c).
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum tokenType {
+    IDENTIFIER,
+    OPERATION,
+    KEYWORDS,
+    RESERVED_WORDS,
+    CONSTANT,
+    NOISE_WORDS,
+    COMMENT,
+    WHITE_SPACE,
+    DELIMITER
+} TokenType;
+
+// Flags for parser predicates, looked up per kind in token_kind_flags
+#define KF_DATA_TYPE   0x01   // int, float, char, ...
+#define KF_SCOPE       0x02   // let, var, out, in, only
+#define KF_ASSIGNMENT  0x04   // =, +=, -=, *=, /=, %=
+
+// Operators and delimiters: X(kind, spelling, token type, flags)
+#define PUNCTUATOR_TABLE(X) \
+    X(TK_PLUS,           "+",  OPERATION,      0) \
+    X(TK_MINUS,          "-",  OPERATION,      0) \
+    X(TK_STAR,           "*",  OPERATION,      0) \
+    X(TK_SLASH,          "/",  OPERATION,      0) \
+    X(TK_PERCENT,        "%",  OPERATION,      0) \
+    X(TK_LT,             "<",  OPERATION,      0) \
+    X(TK_GT,             ">",  OPERATION,      0) \
+    X(TK_ASSIGN,         "=",  OPERATION,      KF_ASSIGNMENT) \
+    X(TK_NOT,            "!",  OPERATION,      0) \
+    X(TK_EQ,             "==", OPERATION,      0) \
+    X(TK_NE,             "!=", OPERATION,      0) \
+    X(TK_LE,             "<=", OPERATION,      0) \
+    X(TK_GE,             ">=", OPERATION,      0) \
+    X(TK_INC,            "++", OPERATION,      0) \
+    X(TK_DEC,            "--", OPERATION,      0) \
+    X(TK_PLUS_ASSIGN,    "+=", OPERATION,      KF_ASSIGNMENT) \
+    X(TK_MINUS_ASSIGN,   "-=", OPERATION,      KF_ASSIGNMENT) \
+    X(TK_STAR_ASSIGN,    "*=", OPERATION,      KF_ASSIGNMENT) \
+    X(TK_SLASH_ASSIGN,   "/=", OPERATION,      KF_ASSIGNMENT) \
+    X(TK_PERCENT_ASSIGN, "%=", OPERATION,      KF_ASSIGNMENT) \
+    X(TK_POWER,          "**", OPERATION,      0) \
+    X(TK_INT_DIV,        "//", OPERATION,      0) \
+    X(TK_AND,            "&&", OPERATION,      0) \
+    X(TK_OR,             "||", OPERATION,      0) \
+    X(TK_SEMICOLON,      ";",  DELIMITER,      0) \
+    X(TK_COLON,          ":",  DELIMITER,      0) \
+    X(TK_COMMA,          ",",  DELIMITER,      0) \
+    X(TK_LPAREN,         "(",  DELIMITER,      0) \
+    X(TK_RPAREN,         ")",  DELIMITER,      0) \
+    X(TK_LBRACE,         "{",  DELIMITER,      0) \
+    X(TK_RBRACE,         "}",  DELIMITER,      0) \
+    X(TK_LBRACKET,       "[",  DELIMITER,      0) \
+    X(TK_RBRACKET,       "]",  DELIMITER,      0)
+
+// Keywords, noise words and reserved words: X(kind, spelling, token type, flags).
+// Adding a keyword is one new line here; the hash slots are rebuilt from
+// this list at startup.
+#define KEYWORD_TABLE(X) \
+    X(TK_ARRAY,     "array",     KEYWORDS,       0) \
+    X(TK_BACK,      "back",      KEYWORDS,       0) \
+    X(TK_BOOL,      "bool",      KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_BREAK,     "break",     KEYWORDS,       0) \
+    X(TK_CATCH,     "catch",     KEYWORDS,       0) \
+    X(TK_CHAR,      "char",      KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_CLASS,     "class",     KEYWORDS,       0) \
+    X(TK_COMPARE,   "compare",   KEYWORDS,       0) \
+    X(TK_CONS,      "cons",      KEYWORDS,       0) \
+    X(TK_CONTINUE,  "continue",  KEYWORDS,       0) \
+    X(TK_DATE,      "date",      KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_DISPLAY,   "display",   KEYWORDS,       0) \
+    X(TK_DO,        "do",        KEYWORDS,       0) \
+    X(TK_EXCLUSIVE, "exclusive", KEYWORDS,       0) \
+    X(TK_FLOAT,     "float",     KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_FUNC,      "func",      KEYWORDS,       0) \
+    X(TK_GO,        "go",        KEYWORDS,       0) \
+    X(TK_HALT,      "halt",      KEYWORDS,       0) \
+    X(TK_IF,        "if",        KEYWORDS,       0) \
+    X(TK_IN,        "in",        KEYWORDS,       KF_SCOPE) \
+    X(TK_INCLUSIVE, "inclusive", KEYWORDS,       0) \
+    X(TK_INT,       "int",       KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_LET,       "let",       KEYWORDS,       KF_SCOPE) \
+    X(TK_LIST,      "list",      KEYWORDS,       0) \
+    X(TK_MAIN,      "main",      KEYWORDS,       0) \
+    X(TK_ONLY,      "only",      KEYWORDS,       KF_SCOPE) \
+    X(TK_OUT,       "out",       KEYWORDS,       KF_SCOPE) \
+    X(TK_PRIV,      "priv",      KEYWORDS,       0) \
+    X(TK_PUB,       "pub",       KEYWORDS,       0) \
+    X(TK_PUT,       "put",       KEYWORDS,       0) \
+    X(TK_RETURN,    "return",    KEYWORDS,       0) \
+    X(TK_STOP,      "stop",      KEYWORDS,       0) \
+    X(TK_TEST,      "test",      KEYWORDS,       0) \
+    X(TK_TEXT,      "text",      KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_THEN,      "then",      KEYWORDS,       0) \
+    X(TK_THIS,      "this",      KEYWORDS,       0) \
+    X(TK_TIME,      "time",      KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_TIMESTAMP, "timestamp", KEYWORDS,       KF_DATA_TYPE) \
+    X(TK_TRY,       "try",       KEYWORDS,       0) \
+    X(TK_UNTIL,     "until",     KEYWORDS,       0) \
+    X(TK_VAR,       "var",       KEYWORDS,       KF_SCOPE) \
+    X(TK_WHAT,      "what",      KEYWORDS,       0) \
+    X(TK_WHEN,      "when",      KEYWORDS,       0) \
+    X(TK_WHILE,     "while",     KEYWORDS,       0) \
+    X(TK_END,       "end",       NOISE_WORDS,    0) \
+    X(TK_CEASE,     "cease",     RESERVED_WORDS, 0) \
+    X(TK_EXIT,      "exit",      RESERVED_WORDS, 0) \
+    X(TK_FALSE,     "false",     RESERVED_WORDS, 0) \
+    X(TK_GOTO,      "goto",      RESERVED_WORDS, 0) \
+    X(TK_SYSTEM,    "system",    RESERVED_WORDS, 0) \
+    X(TK_TRUE,      "true",      RESERVED_WORDS, 0)
+
+// Every token gets one of these kinds, so the parser compares integers
+typedef enum TokenKind {
+    TK_NONE = 0,
+    TK_IDENTIFIER,
+    TK_CONSTANT,
+    TK_STRING,                // "..." as one token, quotes included
+    TK_UNTERMINATED_STRING,   // a '"' with no closing quote: runs to the end of input
+    TK_COMMENT,
+    TK_WHITE_SPACE,
+#define TOKEN_KIND_ENUM(kind, spelling, type, flags) kind,
+    PUNCTUATOR_TABLE(TOKEN_KIND_ENUM)
+    KEYWORD_TABLE(TOKEN_KIND_ENUM)
+#undef TOKEN_KIND_ENUM
+    TK_COUNT
+} TokenKind;
+
+static const char* const token_kind_spelling[TK_COUNT] = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+#define TOKEN_KIND_SPELLING(kind, spelling, type, flags) spelling,
+    PUNCTUATOR_TABLE(TOKEN_KIND_SPELLING)
+    KEYWORD_TABLE(TOKEN_KIND_SPELLING)
+#undef TOKEN_KIND_SPELLING
+};
+
+static const uint8_t token_kind_length[TK_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0,
+#define TOKEN_KIND_LENGTH(kind, spelling, type, flags) sizeof(spelling) - 1,
+    PUNCTUATOR_TABLE(TOKEN_KIND_LENGTH)
+    KEYWORD_TABLE(TOKEN_KIND_LENGTH)
+#undef TOKEN_KIND_LENGTH
+};
+
+static const uint8_t token_kind_type[TK_COUNT] = {
+    IDENTIFIER, IDENTIFIER, CONSTANT, RESERVED_WORDS, RESERVED_WORDS, COMMENT, WHITE_SPACE,
+#define TOKEN_KIND_TYPE(kind, spelling, type, flags) type,
+    PUNCTUATOR_TABLE(TOKEN_KIND_TYPE)
+    KEYWORD_TABLE(TOKEN_KIND_TYPE)
+#undef TOKEN_KIND_TYPE
+};
+
+static const uint8_t token_kind_flags[TK_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0,
+#define TOKEN_KIND_FLAGS(kind, spelling, type, flags) flags,
+    PUNCTUATOR_TABLE(TOKEN_KIND_FLAGS)
+    KEYWORD_TABLE(TOKEN_KIND_FLAGS)
+#undef TOKEN_KIND_FLAGS
+};
+
+// Hash on length, first, third and last character. The multipliers give
+// every word above its own slot; a later collision only costs one probe.
+#define KEYWORD_SLOTS 128
+#define KEYWORD_MAX_LEN 9
+#define KEYWORD_HASH(word, len) \
+    (((unsigned char)(word)[0] * 4u + (unsigned char)(word)[(len) > 2 ? 2 : (len) - 1] * 40u + \
+      (unsigned char)(word)[(len) - 1] * 43u + (unsigned)(len)) & (KEYWORD_SLOTS - 1))
+
+static uint8_t keyword_slots[KEYWORD_SLOTS];
+static bool keyword_slots_ready = false;
+
+static inline void initKeywordTable(void) {
+    static const uint8_t keywords[] = {
+#define KEYWORD_KIND(kind, spelling, type, flags) kind,
+        KEYWORD_TABLE(KEYWORD_KIND)
+#undef KEYWORD_KIND
+    };
+    if (keyword_slots_ready) {
+        return;
+    }
+    memset(keyword_slots, TK_NONE, sizeof(keyword_slots));
+    for (size_t i = 0; i < sizeof(keywords); i++) {
+        unsigned slot = KEYWORD_HASH(token_kind_spelling[keywords[i]], token_kind_length[keywords[i]]);
+        while (keyword_slots[slot] != TK_NONE) {
+            slot = (slot + 1) & (KEYWORD_SLOTS - 1);
+        }
+        keyword_slots[slot] = keywords[i];
+    }
+    keyword_slots_ready = true;
+}
+
+// Returns the keyword kind of word[0..len), or TK_IDENTIFIER
+static inline TokenKind lookupKeyword(const char* word, size_t len) {
+    if (len < 2 || len > KEYWORD_MAX_LEN) {
+        return TK_IDENTIFIER;
+    }
+    unsigned slot = KEYWORD_HASH(word, len);
+    for (;;) {
+        int kind = keyword_slots[slot];
+        if (kind == TK_NONE) {
+            return TK_IDENTIFIER;
+        }
+        if (token_kind_length[kind] == len && memcmp(token_kind_spelling[kind], word, len) == 0) {
+            return (TokenKind)kind;
+        }
+        slot = (slot + 1) & (KEYWORD_SLOTS - 1);
+    }
+}
+
+// Kind of a one- or two-character operator or delimiter, or TK_NONE
+static inline TokenKind punctuatorKind(const char* text, size_t len) {
+    char next = len > 1 ? text[1] : '\0';
+    if (len > 2) {
+        return TK_NONE;
+    }
+    switch (text[0]) {
+        case '+': return next == '+' ? TK_INC : next == '=' ? TK_PLUS_ASSIGN : len == 1 ? TK_PLUS : TK_NONE;
+        case '-': return next == '-' ? TK_DEC : next == '=' ? TK_MINUS_ASSIGN : len == 1 ? TK_MINUS : TK_NONE;
+        case '*': return next == '*' ? TK_POWER : next == '=' ? TK_STAR_ASSIGN : len == 1 ? TK_STAR : TK_NONE;
+        case '/': return next == '/' ? TK_INT_DIV : next == '=' ? TK_SLASH_ASSIGN : len == 1 ? TK_SLASH : TK_NONE;
+        case '%': return next == '=' ? TK_PERCENT_ASSIGN : len == 1 ? TK_PERCENT : TK_NONE;
+        case '<': return next == '=' ? TK_LE : len == 1 ? TK_LT : TK_NONE;
+        case '>': return next == '=' ? TK_GE : len == 1 ? TK_GT : TK_NONE;
+        case '=': return next == '=' ? TK_EQ : len == 1 ? TK_ASSIGN : TK_NONE;
+        case '!': return next == '=' ? TK_NE : len == 1 ? TK_NOT : TK_NONE;
+        case '&': return next == '&' ? TK_AND : TK_NONE;
+        case '|': return next == '|' ? TK_OR : TK_NONE;
+        default: break;
+    }
+    if (len != 1) {
+        return TK_NONE;
+    }
+    switch (text[0]) {
+        case ';': return TK_SEMICOLON;
+        case ':': return TK_COLON;
+        case ',': return TK_COMMA;
+        case '(': return TK_LPAREN;
+        case ')': return TK_RPAREN;
+        case '{': return TK_LBRACE;
+        case '}': return TK_RBRACE;
+        case '[': return TK_LBRACKET;
+        case ']': return TK_RBRACKET;
+        default: return TK_NONE;
+    }
+}
+
+// A token is a span of the input; the lexeme is only copied out when
+// printed, and its line and column are only worked out from the line-start
+// table (LineIndex in lexer.h) when a message needs them. The layout is fixed
+// because the binary token stream stores this struct as-is.
+typedef struct Token {
+    uint64_t start;       // byte offset of the lexeme in the input
+    uint32_t length;      // lexeme length in bytes
+    uint32_t name_id;     // interned identifier (see intern.h), or 0
+    uint8_t type;         // TokenType
+    uint8_t kind;         // TokenKind
+    uint8_t reserved[6];  // always zero
+} Token;
+
+_Static_assert(sizeof(Token) == 24, "Token is part of the binary token stream format");
+
+// Whitespace or a comment, kept beside the token stream rather than in it.
+// Consecutive whitespace bytes share one entry up to and including a
+// newline, so a formatted line costs about two entries: its indentation and
+// its end.
+typedef struct Trivia {
+    uint64_t start;       // byte offset in the input
+    uint32_t length;      // bytes; a whitespace run stands for one token per byte
+    uint8_t kind;         // TK_WHITE_SPACE or TK_COMMENT
+    uint8_t reserved[3];  // always zero
+} Trivia;
+
+_Static_assert(sizeof(Trivia) == 16, "Trivia is part of the binary token stream format");
+
+// Bytes [offset, offset + size) of the input. When the input is read in
+// chunks this is a sliding window, so only recent tokens can be printed.
+typedef struct SourceText {
+    const char* data;
+    uint64_t offset;
+    size_t size;
+} SourceText;
+
+// Binary token stream written by the lexer (SymbolTable.bin) and mapped by
+// the parser. All integers are in host byte order; bump the version on any
+// layout change.
+#define TOKEN_STREAM_MAGIC "LXTK"
+#define TOKEN_STREAM_VERSION 6
+#define TOKEN_STREAM_ALIGN(offset) (((offset) + 7) & ~(uint64_t)7)
+
+typedef struct TokenStreamHeader {
+    char magic[4];            // TOKEN_STREAM_MAGIC
+    uint32_t version;         // TOKEN_STREAM_VERSION
+    uint32_t token_size;      // sizeof(Token)
+    uint32_t reserved;
+    uint64_t token_count;
+    uint64_t text_size;       // source bytes that token spans point into
+    uint64_t line_count;      // entries in the line-start table
+    uint64_t tokens_offset;   // file offset of Token[token_count]
+    uint64_t text_offset;     // file offset of the source text
+    uint64_t lines_offset;    // file offset of uint64_t[line_count]
+    uint64_t trivia_count;
+    uint64_t trivia_offset;   // file offset of Trivia[trivia_count]
+} TokenStreamHeader;
+
+#endif